@@ -0,0 +1,72 @@
+// SimStepBench.cpp
+// Steps one ensemble scenario headless and reports the time per step and
+// the energy at the start and end of the run. The same source is built
+// once per REACTOR_PRECISION (SimStepBenchFloat, ...Double, ...Mixed), so
+// running them side by side compares throughput against drift.
+//
+// By default the box is closed: reactions off (pairs bounce elastically)
+// and the left wall at temperature 1, so the energy only moves through
+// rounding. Reactions and wall heating change it by far more than that.
+//
+//   SimStepBenchFloat  --rounds 2000 --steps 1000
+//   SimStepBenchDouble --rounds 2000 --steps 1000 --threads 4
+//   SimStepBenchFloat  --reactions 1 --temp 1.4     open box, throughput only
+#include "sim/Ensemble.hpp"
+#include "sim/Reactor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    EnsembleConfig config;
+    config.name           = "bench";
+    config.roundMolecules = 2000;
+    config.steps          = 1000;
+    config.reactions      = false;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+
+        if      (arg == "--rounds")    config.roundMolecules  = std::stoi(value);
+        else if (arg == "--squares")   config.squareMolecules = std::stoi(value);
+        else if (arg == "--steps")     config.steps           = std::stoi(value);
+        else if (arg == "--temp")      config.wallTemperature = std::stof(value);
+        else if (arg == "--seed")      config.seed            = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--threads")   config.simWorkers      = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--reactions") config.reactions       = value != "0";
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    auto reactor = EnsembleRunner::createReactor(config);
+    reactor->update(config.dt);
+    Accum startEnergy = reactor->getEnergyHistory().back();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 1; step < config.steps; ++step) {
+        reactor->update(config.dt);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Accum endEnergy = reactor->getEnergyHistory().back();
+    double drift = startEnergy != 0 ? (endEnergy - startEnergy) / static_cast<double>(startEnergy) : 0;
+    int steps = std::max(1, config.steps - 1);
+    bool closed = !config.reactions && reactor->getLeftWallTemperature() == 1;
+
+    std::cout << std::setprecision(10)
+              << "precision      " << REACTOR_PRECISION_NAME
+              << " (Real " << sizeof(Real) * 8 << " bit, Accum " << sizeof(Accum) * 8 << " bit)\n"
+              << "molecules      " << reactor->getMolecules().size() << '\n'
+              << "steps          " << steps << '\n'
+              << "ms/step        " << seconds * 1000 / steps << '\n'
+              << "energy start   " << startEnergy << '\n'
+              << "energy end     " << endEnergy << '\n'
+              << "energy drift   " << drift << (closed ? "" : "  (open box: reactions or wall heating)") << '\n';
+    return 0;
+}
@@ -0,0 +1,258 @@
+// UIDispatchBench.cpp
+// Builds a widget tree without opening a window and replays mouse input
+// through UIApplication::handleEvent, reporting throughput and per-event
+// latency. With --max-p99-us it exits non-zero when p99 exceeds the limit.
+//
+//   UIDispatchBench --widgets 20000 --depth 6 --windows 8 --events 200000
+//   UIDispatchBench --record stream.txt ...     save the generated input
+//   UIDispatchBench --replay stream.txt ...     replay a recorded input
+//
+// Stream files hold one event per line: "move x y", "press x y" or
+// "release x y".
+#include "ui/UIApplication.hpp"
+#include "ui/Widget.hpp"
+#include "ui/Container.hpp"
+#include "ui/Window.hpp"
+#include "ui/Button.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float ROOT_WIDTH  = 1500;
+const float ROOT_HEIGHT = 900;
+
+struct BenchOptions {
+    int          widgets  = 10000;
+    int          depth    = 4;
+    int          windows  = 8;
+    int          events   = 100000;
+    unsigned int seed     = 1;
+    double       maxP99Us = 0;
+    std::string  replayPath;
+    std::string  recordPath;
+};
+
+int buildTree(Widget& root, const BenchOptions& options, int& clicks) {
+    int created = 0;
+    int windows = std::max(1, options.windows);
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(windows))));
+    int rows    = (windows + columns - 1) / columns;
+    float cellW = ROOT_WIDTH  / columns;
+    float cellH = ROOT_HEIGHT / rows;
+    int leavesPerWindow = std::max(1, options.widgets / windows - options.depth);
+
+    for (int w = 0; w < windows; ++w) {
+        sf::FloatRect rect((w % columns) * cellW + 5, (w / columns) * cellH + 5, cellW - 10, cellH - 10);
+        auto window = std::make_unique<Window>("Bench " + std::to_string(w), rect);
+        window->setZOrder(w);
+        created++;
+
+        // Nested containers, each inset a little inside its parent.
+        std::vector<std::unique_ptr<Widget>> chain;
+        sf::FloatRect inner(rect.left, rect.top + 30, rect.width, rect.height - 30);
+        for (int d = 1; d < options.depth; ++d) {
+            inner = sf::FloatRect(inner.left + 2, inner.top + 2, inner.width - 4, inner.height - 4);
+            auto container = std::make_unique<Container>();
+            container->setRect(inner);
+            chain.push_back(std::move(container));
+            created++;
+        }
+
+        Widget* leafParent = chain.empty() ? static_cast<Widget*>(window.get()) : chain.back().get();
+        int gridCols = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(leavesPerWindow))));
+        int gridRows = (leavesPerWindow + gridCols - 1) / gridCols;
+        float buttonW = inner.width  / gridCols;
+        float buttonH = inner.height / gridRows;
+
+        for (int b = 0; b < leavesPerWindow; ++b) {
+            auto button = std::make_unique<Button>("");
+            button->setRect(sf::FloatRect(inner.left + (b % gridCols) * buttonW,
+                                          inner.top  + (b / gridCols) * buttonH,
+                                          buttonW, buttonH));
+            button->setOnClick([&clicks]() { clicks++; });
+            leafParent->addChild(std::move(button));
+            created++;
+        }
+
+        for (size_t d = chain.size(); d-- > 1; ) {
+            chain[d - 1]->addChild(std::move(chain[d]));
+        }
+        if (!chain.empty()) {
+            window->addChild(std::move(chain.front()));
+        }
+        root.addChild(std::move(window));
+    }
+
+    return created;
+}
+
+sf::Event makeEvent(const std::string& kind, int x, int y) {
+    sf::Event event;
+    if (kind == "move") {
+        event.type = sf::Event::MouseMoved;
+        event.mouseMove.x = x;
+        event.mouseMove.y = y;
+    } else {
+        event.type = kind == "press" ? sf::Event::MouseButtonPressed : sf::Event::MouseButtonReleased;
+        event.mouseButton.button = sf::Mouse::Left;
+        event.mouseButton.x = x;
+        event.mouseButton.y = y;
+    }
+    return event;
+}
+
+struct StreamEvent {
+    std::string kind;
+    int x, y;
+};
+
+std::vector<StreamEvent> generateStream(const BenchOptions& options) {
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> distX(0, static_cast<int>(ROOT_WIDTH)  - 1);
+    std::uniform_int_distribution<int> distY(0, static_cast<int>(ROOT_HEIGHT) - 1);
+    std::uniform_int_distribution<int> jitter(-4, 4);
+
+    std::vector<StreamEvent> stream;
+    stream.reserve(options.events);
+
+    // Mostly short drifts of the pointer, with an occasional click.
+    int x = distX(rng), y = distY(rng);
+    while (static_cast<int>(stream.size()) < options.events) {
+        if (rng() % 64 == 0) {
+            x = distX(rng);
+            y = distY(rng);
+        }
+        x = std::clamp(x + jitter(rng), 0, static_cast<int>(ROOT_WIDTH)  - 1);
+        y = std::clamp(y + jitter(rng), 0, static_cast<int>(ROOT_HEIGHT) - 1);
+        stream.push_back({"move", x, y});
+
+        if (rng() % 20 == 0) {
+            stream.push_back({"press",   x, y});
+            stream.push_back({"release", x, y});
+        }
+    }
+    stream.resize(options.events);
+    return stream;
+}
+
+bool loadStream(const std::string& path, std::vector<StreamEvent>& stream) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    StreamEvent event;
+    while (in >> event.kind >> event.x >> event.y) {
+        if (event.kind == "move" || event.kind == "press" || event.kind == "release") {
+            stream.push_back(event);
+        }
+    }
+    return true;
+}
+
+bool saveStream(const std::string& path, const std::vector<StreamEvent>& stream) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    for (const auto& event : stream) {
+        out << event.kind << ' ' << event.x << ' ' << event.y << '\n';
+    }
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+
+        if      (arg == "--widgets")    options.widgets    = std::stoi(value);
+        else if (arg == "--depth")      options.depth      = std::max(1, std::stoi(value));
+        else if (arg == "--windows")    options.windows    = std::stoi(value);
+        else if (arg == "--events")     options.events     = std::stoi(value);
+        else if (arg == "--seed")       options.seed       = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--max-p99-us") options.maxP99Us   = std::stod(value);
+        else if (arg == "--replay")     options.replayPath = value;
+        else if (arg == "--record")     options.recordPath = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    int clicks = 0;
+    auto root = std::make_unique<Widget>();
+    root->setRect(sf::FloatRect(0, 0, ROOT_WIDTH, ROOT_HEIGHT));
+
+    auto buildStart = std::chrono::steady_clock::now();
+    int widgets = buildTree(*root, options, clicks) + 1;
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+    UIApplication app;
+    app.setRoot(std::move(root));
+
+    std::vector<StreamEvent> stream;
+    if (!options.replayPath.empty()) {
+        if (!loadStream(options.replayPath, stream)) {
+            std::cerr << "Failed to read " << options.replayPath << std::endl;
+            return 2;
+        }
+    } else {
+        stream = generateStream(options);
+    }
+
+    if (!options.recordPath.empty() && !saveStream(options.recordPath, stream)) {
+        std::cerr << "Failed to write " << options.recordPath << std::endl;
+        return 2;
+    }
+
+    std::vector<sf::Event> events;
+    events.reserve(stream.size());
+    for (const auto& e : stream) {
+        events.push_back(makeEvent(e.kind, e.x, e.y));
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(events.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& event : events) {
+        auto t0 = std::chrono::steady_clock::now();
+        app.handleEvent(event);
+        auto t1 = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    double p99 = percentile(latencies, 0.99);
+
+    std::cout << "widgets        " << widgets << " (depth " << options.depth
+              << ", windows " << options.windows << ", built in " << buildMs << " ms)\n"
+              << "events         " << events.size() << " (" << clicks << " clicks)\n"
+              << "events/sec     " << (seconds > 0 ? events.size() / seconds : 0) << "\n"
+              << "latency us     p50 " << percentile(latencies, 0.50)
+              << "  p90 " << percentile(latencies, 0.90)
+              << "  p99 " << p99
+              << "  max " << (latencies.empty() ? 0 : latencies.back()) << std::endl;
+
+    if (options.maxP99Us > 0 && p99 > options.maxP99Us) {
+        std::cerr << "p99 latency " << p99 << " us exceeds limit " << options.maxP99Us << " us" << std::endl;
+        return 1;
+    }
+    return 0;
+}
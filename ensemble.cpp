@@ -0,0 +1,119 @@
+// ensemble.cpp
+// Headless parameter sweep: runs the cartesian product of the given lists
+// on a thread pool and writes one CSV row per run.
+//
+//   ReactorEnsemble --temps 0.6,1,2 --widths 300,500 --rounds 1000
+//                   --squares 0,100 --repeats 4 --steps 6000 --out sweep.csv
+#include "sim/Ensemble.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template<typename T>
+static std::vector<T> parseList(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        std::stringstream is(item);
+        T value;
+        is >> value;
+        values.push_back(value);
+    }
+    return values;
+}
+
+static void printUsage() {
+    std::cerr << "usage: ReactorEnsemble [--temps t1,t2,..] [--widths w1,..] [--height h]\n"
+                 "                       [--rounds n1,..] [--squares n1,..] [--repeats r]\n"
+                 "                       [--steps n] [--dt s] [--seed s] [--threads n] [--out file]\n"
+                 "                       [--swept 0|1] [--sim-threads n] [--reorder steps]\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<float> temps   = {1.0f};
+    std::vector<float> widths  = {500.f};
+    std::vector<int>   rounds  = {1000};
+    std::vector<int>   squares = {0};
+    EnsembleConfig     base;
+    int                repeats = 1;
+    unsigned int       threads = 0;
+    std::string        outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if      (arg == "--temps")   temps   = parseList<float>(value);
+        else if (arg == "--widths")  widths  = parseList<float>(value);
+        else if (arg == "--rounds")  rounds  = parseList<int>  (value);
+        else if (arg == "--squares") squares = parseList<int>  (value);
+        else if (arg == "--height")  base.height = std::stof(value);
+        else if (arg == "--repeats") repeats     = std::stoi(value);
+        else if (arg == "--steps")   base.steps  = std::stoi(value);
+        else if (arg == "--dt")      base.dt     = std::stof(value);
+        else if (arg == "--seed")    base.seed   = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--swept")   base.sweptCollisions = value != "0";
+        else if (arg == "--threads") threads     = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--sim-threads") base.simWorkers = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--reorder") base.reorderInterval = std::stoi(value);
+        else if (arg == "--out")     outPath     = value;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<EnsembleConfig> configs;
+    for (float temp : temps) {
+        for (float width : widths) {
+            for (int round : rounds) {
+                for (int square : squares) {
+                    for (int r = 0; r < repeats; ++r) {
+                        EnsembleConfig config = base;
+                        config.wallTemperature = temp;
+                        config.width           = width;
+                        config.roundMolecules  = round;
+                        config.squareMolecules = square;
+                        config.seed            = base.seed + static_cast<unsigned int>(configs.size());
+                        config.name            = "t" + std::to_string(temp).substr(0, 4) +
+                                                 "_w" + std::to_string(static_cast<int>(width)) +
+                                                 "_r" + std::to_string(round) +
+                                                 "_s" + std::to_string(square);
+                        configs.push_back(config);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!outPath.empty()) {
+        file.open(outPath);
+        if (!file) {
+            std::cerr << "Failed to open " << outPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outPath.empty() ? std::cout : file;
+
+    EnsembleRunner runner(threads);
+    std::cerr << "Running " << configs.size() << " configurations on "
+              << runner.getThreadCount() << " threads" << std::endl;
+
+    EnsembleRunner::writeCsvHeader(out);
+    runner.run(configs, [&out](const EnsembleResult& result) {
+        EnsembleRunner::writeCsvRow(out, result);
+        out.flush();
+    });
+
+    return 0;
+}
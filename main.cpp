@@ -2,6 +2,9 @@
 #include <SFML/Graphics.hpp>
 #include "ui/ReactorUI.hpp"
 #include "sim/Reactor.hpp"
+#include "sim/TrajectoryWriter.hpp"
+#include <iostream>
+#include <string>
 
 const int   WINDOW_WIDTH      = 1500;
 const int   WINDOW_HEIGHT     = 900;
@@ -14,22 +17,76 @@ const float MOLECULE_RADIUS   = 1.f;
 const float SQUARE_SIZE       = 2.f;
 const int   INITIAL_MOLECULES = 1000;
 const float MOLECULE_SPEED    = 100.f;
+const int   UNFOCUSED_FPS     = 15;
+const int   IDLE_POLL_RATE    = 120;
+const int   SHM_CAPACITY      = 20000;
+const float MIN_WIDTH         = 200.f;
+const float MAX_WIDTH         = 50000.f;
+const float REORDER_LOCALITY  = 0.3f;
+
+// ReactorSimulator [--shm /name [--shm-capacity molecules]]
+//                  [--trajectory file [--trajectory-every steps]]
+//                  [--max-width units] [--reorder steps]
+//                  [--reaction-budget pairs] [--population-cap molecules]
+int main(int argc, char** argv) {
+    std::string shm_name;
+    int shm_capacity = SHM_CAPACITY;
+    std::string trajectory_path;
+    TrajectoryOptions trajectory_options;
+    float max_width = MAX_WIDTH;
+    int reorder_steps = 0;
+    int reaction_budget = 0;
+    size_t population_cap = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if      (arg == "--shm")              shm_name     = argv[i + 1];
+        else if (arg == "--shm-capacity")     shm_capacity = std::stoi(argv[i + 1]);
+        else if (arg == "--trajectory")       trajectory_path = argv[i + 1];
+        else if (arg == "--trajectory-every") trajectory_options.sampleInterval = std::stoul(argv[i + 1]);
+        else if (arg == "--max-width")        max_width = std::stof(argv[i + 1]);
+        else if (arg == "--reorder")          reorder_steps = std::stoi(argv[i + 1]);
+        else if (arg == "--reaction-budget")  reaction_budget = std::stoi(argv[i + 1]);
+        else if (arg == "--population-cap")   population_cap  = std::stoul(argv[i + 1]);
+    }
 
-int main() {
     Reactor reactor(REACTOR_X, REACTOR_Y, REACTOR_WIDTH, REACTOR_HEIGHT, 
                    WALL_THICKNESS, MOLECULE_RADIUS, SQUARE_SIZE, MOLECULE_SPEED);
     
+    reactor.setWorkerCount(0);
+    // Off by default: reordering changes which pairs react first, so runs
+    // stop matching runs without it.
+    if (reorder_steps > 0) reactor.setReorderPolicy(reorder_steps, REORDER_LOCALITY);
+    // Both change which pairs react and when; off unless asked for here or
+    // from the control window.
+    reactor.setReactionBudget(reaction_budget);
+    if (population_cap > 0) reactor.setPopulationCap(population_cap, PopulationPolicy::Merge);
+    if (!shm_name.empty() && !reactor.enableSharedExport(shm_name, shm_capacity)) {
+        std::cerr << "Failed to create shared memory " << shm_name << std::endl;
+    }
+    
     for (int i = 0; i < INITIAL_MOLECULES; ++i) {
         reactor.addRoundMolecule();
     }
     
+    TrajectoryWriter trajectory;
+    if (!trajectory_path.empty()) {
+        if (trajectory.open(trajectory_path, trajectory_options)) {
+            reactor.addStepObserver([&trajectory](const Reactor& r) { trajectory.record(r); });
+        } else {
+            std::cerr << "Failed to create " << trajectory_path << std::endl;
+        }
+    }
+    
     ReactorUI reactor_ui(reactor);
+    reactor_ui.setWidthLimits(MIN_WIDTH, max_width);
     if (!reactor_ui.initialize()) {
         return -1;
     }
     
     sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Reactor Simulator");
     sf::Clock clock;
+    bool focused = true;
+    unsigned frame_cap = 0;
     
     while (window.isOpen()) {
         float dt = clock.restart().asSeconds();
@@ -40,15 +97,29 @@ int main() {
             if (event.type == sf::Event::Closed) {
                 window.close();
             }
+            if (event.type == sf::Event::LostFocus)   focused = false;
+            if (event.type == sf::Event::GainedFocus) focused = true;
             reactor_ui.handleEvent(event);
         }
         
-        reactor.update(dt);
+        reactor_ui.stepSimulation(dt);
         reactor_ui.update(dt);
         
-        window.clear(sf::Color(20, 20, 30));
-        reactor_ui.render(window);
-        window.display();
+        unsigned cap = focused ? reactor_ui.getFrameCap() : UNFOCUSED_FPS;
+        if (cap != frame_cap) {
+            frame_cap = cap;
+            window.setFramerateLimit(frame_cap);
+        }
+        
+        if (reactor_ui.needsRedraw()) {
+            window.clear(sf::Color(20, 20, 30));
+            reactor_ui.render(window);
+            window.display();
+            reactor_ui.markPresented();
+        } else if (!reactor_ui.isFastForward() || reactor_ui.isPaused()) {
+            // Nothing changed: wait out the frame instead of spinning.
+            sf::sleep(sf::seconds(1.f / (frame_cap ? frame_cap : IDLE_POLL_RATE)));
+        }
     }
     
     return 0;
@@ -0,0 +1,130 @@
+// Ensemble.cpp
+#include "Ensemble.hpp"
+#include "Reactor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+template<typename T>
+float tailAverage(const std::deque<T>& data, size_t count) {
+    if (data.empty() || count == 0) return 0;
+
+    count = std::min(count, data.size());
+    double sum = 0;
+    for (auto it = data.end() - count; it != data.end(); ++it) {
+        sum += *it;
+    }
+    return static_cast<float>(sum / count);
+}
+
+}
+
+EnsembleRunner::EnsembleRunner(unsigned int threads) : threads_(threads) {
+    if (threads_ == 0) {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::unique_ptr<Reactor> EnsembleRunner::createReactor(const EnsembleConfig& config) {
+    auto reactor = std::make_unique<Reactor>(0, 0, config.width, config.height, config.wallThickness,
+                                             config.moleculeRadius, config.squareSize, config.moleculeSpeed);
+    reactor->seed(config.seed);
+    reactor->setLeftWallTemperature(config.wallTemperature);
+    reactor->setCollisionMode(config.sweptCollisions ? CollisionMode::Swept : CollisionMode::Discrete);
+    reactor->setReactionsEnabled(config.reactions);
+    reactor->setWorkerCount(config.simWorkers);
+    reactor->setReorderPolicy(config.reorderInterval);
+
+    for (int i = 0; i < config.roundMolecules; ++i) {
+        reactor->addRoundMolecule();
+    }
+    for (int i = 0; i < config.squareMolecules; ++i) {
+        reactor->addSquareMolecule();
+    }
+    return reactor;
+}
+
+EnsembleResult EnsembleRunner::runSingle(const EnsembleConfig& config, size_t index) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto owner = createReactor(config);
+    Reactor& reactor = *owner;
+    for (int step = 0; step < config.steps; ++step) {
+        reactor.update(config.dt);
+    }
+
+    size_t window = std::max<size_t>(1, reactor.getMoleculeHistory().size() / 4);
+
+    EnsembleResult result;
+    result.run               = index;
+    result.name              = config.name;
+    result.seed              = config.seed;
+    result.wallTemperature   = reactor.getLeftWallTemperature();
+    result.width             = config.width;
+    result.initialRound      = config.roundMolecules;
+    result.initialSquare     = config.squareMolecules;
+    result.equilibriumTotal  = tailAverage(reactor.getMoleculeHistory      (), window);
+    result.equilibriumRound  = tailAverage(reactor.getRoundMoleculeHistory (), window);
+    result.equilibriumSquare = tailAverage(reactor.getSquareMoleculeHistory(), window);
+    result.equilibriumEnergy = tailAverage(reactor.getEnergyHistory        (), window);
+
+    float simTime = config.steps * config.dt;
+    result.rightWallHitRate = simTime > 0 ? reactor.getTotalRightWallHits() / simTime : 0;
+
+    result.wallTimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::vector<EnsembleResult> EnsembleRunner::run(const std::vector<EnsembleConfig>& configs,
+                                                const std::function<void(const EnsembleResult&)>& onResult) const {
+    std::vector<EnsembleResult> results(configs.size());
+    std::atomic<size_t> next{0};
+    std::mutex reportMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < configs.size(); i = next++) {
+            results[i] = runSingle(configs[i], i);
+            if (onResult) {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                onResult(results[i]);
+            }
+        }
+    };
+
+    size_t count = std::min<size_t>(threads_, configs.size());
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < count; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    return results;
+}
+
+void EnsembleRunner::writeCsvHeader(std::ostream& out) {
+    out << "run,name,seed,wall_temperature,width,initial_round,initial_square,"
+           "eq_total,eq_round,eq_square,eq_energy,right_wall_hits_per_s,wall_time_s\n";
+}
+
+void EnsembleRunner::writeCsvRow(std::ostream& out, const EnsembleResult& result) {
+    out << result.run               << ','
+        << result.name              << ','
+        << result.seed              << ','
+        << result.wallTemperature   << ','
+        << result.width             << ','
+        << result.initialRound      << ','
+        << result.initialSquare     << ','
+        << result.equilibriumTotal  << ','
+        << result.equilibriumRound  << ','
+        << result.equilibriumSquare << ','
+        << result.equilibriumEnergy << ','
+        << result.rightWallHitRate  << ','
+        << result.wallTimeSeconds   << '\n';
+}
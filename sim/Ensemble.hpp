@@ -0,0 +1,75 @@
+// Ensemble.hpp
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Reactor;
+
+struct EnsembleConfig {
+    std::string  name;
+    float        wallTemperature = 1.0f;
+    float        width           = 500.f;
+    float        height          = 400.f;
+    float        wallThickness   = 10.f;
+    float        moleculeRadius  = 1.f;
+    float        squareSize      = 2.f;
+    float        moleculeSpeed   = 100.f;
+    int          roundMolecules  = 1000;
+    int          squareMolecules = 0;
+    int          steps           = 6000;
+    float        dt              = 1.f / 60.f;
+    unsigned int seed            = 1;
+    bool         sweptCollisions = false;
+    bool         reactions       = true;
+    unsigned int simWorkers      = 1;
+    int          reorderInterval = 0;
+};
+
+struct EnsembleResult {
+    size_t       run = 0;
+    std::string  name;
+    unsigned int seed = 0;
+    float        wallTemperature = 0;
+    float        width = 0;
+    int          initialRound = 0;
+    int          initialSquare = 0;
+
+    // Averaged over the last quarter of the run.
+    float        equilibriumTotal  = 0;
+    float        equilibriumRound  = 0;
+    float        equilibriumSquare = 0;
+    float        equilibriumEnergy = 0;
+
+    float        rightWallHitRate = 0;
+    double       wallTimeSeconds  = 0;
+};
+
+class EnsembleRunner {
+private:
+    unsigned int threads_;
+
+public:
+    // threads == 0 picks std::thread::hardware_concurrency().
+    explicit EnsembleRunner(unsigned int threads = 0);
+
+    unsigned int getThreadCount() const { return threads_; }
+
+    // Runs every config on the pool. onResult is called (serialised) as soon
+    // as each run finishes; the returned vector is in config order.
+    std::vector<EnsembleResult> run(const std::vector<EnsembleConfig>& configs,
+                                    const std::function<void(const EnsembleResult&)>& onResult = {}) const;
+
+    static EnsembleResult runSingle(const EnsembleConfig& config, size_t index = 0);
+    // The seeded, populated reactor a run starts from.
+    static std::unique_ptr<Reactor> createReactor(const EnsembleConfig& config);
+
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsvRow   (std::ostream& out, const EnsembleResult& result);
+};
+
+#endif // ENSEMBLE_HPP
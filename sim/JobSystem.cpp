@@ -0,0 +1,137 @@
+// JobSystem.cpp
+#include "JobSystem.hpp"
+
+namespace {
+// Set on pool threads and on a caller while it runs chunks, so a nested
+// parallel call runs inline instead of waiting on the busy pool.
+thread_local bool insideJob = false;
+}
+
+JobSystem::JobSystem(size_t workers) {
+    start(workers);
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+void JobSystem::setWorkerCount(size_t workers) {
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    stop();
+    start(workers);
+}
+
+void JobSystem::start(size_t workers) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_ = workers;
+    stop_ = false;
+
+    queues_.clear();
+    for (size_t w = 0; w < workers_; ++w) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t w = 1; w < workers_; ++w) {
+        threads_.emplace_back(&JobSystem::workerLoop, this, w);
+    }
+}
+
+void JobSystem::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+}
+
+void JobSystem::workerLoop(size_t worker) {
+    insideJob = true;
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        participate(worker);
+    }
+}
+
+bool JobSystem::takeChunk(size_t worker, size_t& chunk) {
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.front();
+            own.chunks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < workers_; ++offset) {
+        Queue& victim = *queues_[(worker + offset) % workers_];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::participate(size_t worker) {
+    size_t chunk;
+    while (takeChunk(worker, chunk)) {
+        (*task_)(chunk, worker);
+        if (pending_.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(done_mutex_);
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void JobSystem::run(size_t chunks, const Task& task) {
+    if (chunks == 0) return;
+
+    if (workers_ == 1 || chunks == 1 || insideJob) {
+        for (size_t c = 0; c < chunks; ++c) {
+            task(c, 0);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(run_mutex_);
+    task_ = &task;
+    pending_ = chunks;
+
+    // Contiguous runs keep neighbouring chunks on one worker until stolen.
+    for (size_t w = 0; w < workers_; ++w) {
+        size_t begin = chunks * w / workers_;
+        size_t end   = chunks * (w + 1) / workers_;
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (size_t c = begin; c < end; ++c) {
+            queues_[w]->chunks.push_back(c);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        generation_++;
+    }
+    wake_cv_.notify_all();
+
+    insideJob = true;
+    participate(0);
+    insideJob = false;
+
+    std::unique_lock<std::mutex> lock(done_mutex_);
+    done_cv_.wait(lock, [&]() { return pending_ == 0; });
+    task_ = nullptr;
+}
@@ -0,0 +1,119 @@
+// JobSystem.hpp
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads with one chunk queue each. A parallel call
+// deals its chunks out in contiguous runs, every worker drains its own
+// queue from the front and then steals from the back of the others. The
+// calling thread works as worker 0 and returns once all chunks are done.
+//
+// With one worker nothing is queued and the whole range runs as a single
+// chunk on the caller, so results match a plain serial loop exactly. With
+// more, chunk boundaries depend only on the count and `grain` and
+// reductions combine in chunk order, so results are the same for any
+// number of workers above one; float sums differ from the serial loop by
+// rounding only.
+class JobSystem {
+public:
+    using Task = std::function<void(size_t chunk, size_t worker)>;
+
+private:
+    struct Queue {
+        std::mutex         mutex;
+        std::deque<size_t> chunks;
+    };
+
+    size_t workers_ = 1;
+    std::vector<std::thread>            threads_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    std::mutex              run_mutex_;
+    std::mutex              wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::mutex              done_mutex_;
+    std::condition_variable done_cv_;
+    std::atomic<size_t>     pending_{0};
+    unsigned long long      generation_ = 0;
+    bool                    stop_ = false;
+    const Task*             task_ = nullptr;
+
+    void start(size_t workers);
+    void stop ();
+    void workerLoop (size_t worker);
+    void participate(size_t worker);
+    bool takeChunk  (size_t worker, size_t& chunk);
+    void run(size_t chunks, const Task& task);
+
+public:
+    explicit JobSystem(size_t workers = 1);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 0 picks the hardware concurrency. Must not be called from a job.
+    void   setWorkerCount(size_t workers);
+    size_t getWorkerCount() const { return workers_; }
+
+    // fn(begin, end, worker) for consecutive chunks of `grain` items, the
+    // last one possibly shorter, or once over everything with one worker;
+    // `worker` is below getWorkerCount() and unique among running chunks.
+    template<typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        if (workers_ == 1) {
+            fn(size_t(0), count, size_t(0));
+            return;
+        }
+        grain = std::max<size_t>(1, grain);
+        size_t chunks = (count + grain - 1) / grain;
+
+        Task task = [&](size_t chunk, size_t worker) {
+            size_t begin = chunk * grain;
+            fn(begin, std::min(count, begin + grain), worker);
+        };
+        run(chunks, task);
+    }
+
+    // Each chunk folds its range into a copy of `identity` with
+    // fn(begin, end, accumulator); the partials are then combined in chunk
+    // order, so the result does not depend on which worker ran what. One
+    // worker folds the whole range into a single running accumulator.
+    template<typename T, typename Fn, typename Combine>
+    T parallelReduce(size_t count, size_t grain, const T& identity, Fn&& fn, Combine&& combine) {
+        if (count == 0) return identity;
+        if (workers_ == 1) {
+            T result = identity;
+            fn(size_t(0), count, result);
+            return result;
+        }
+        grain = std::max<size_t>(1, grain);
+        size_t chunks = (count + grain - 1) / grain;
+
+        std::vector<T> partials(chunks, identity);
+        Task task = [&](size_t chunk, size_t) {
+            size_t begin = chunk * grain;
+            fn(begin, std::min(count, begin + grain), partials[chunk]);
+        };
+        run(chunks, task);
+
+        if (chunks == 1) return partials.front();
+        T result = identity;
+        for (const T& partial : partials) {
+            combine(result, partial);
+        }
+        return result;
+    }
+};
+
+#endif // JOB_SYSTEM_HPP
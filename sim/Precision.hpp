@@ -0,0 +1,26 @@
+// Precision.hpp
+#ifndef PRECISION_HPP
+#define PRECISION_HPP
+
+// Scalar types of the simulation core, chosen per build with the
+// REACTOR_PRECISION CMake option:
+//   float   Real = float,  Accum = float   (default, least bandwidth)
+//   double  Real = double, Accum = double  (long runs)
+//   mixed   Real = float,  Accum = double  (float state, double sums)
+// Real is molecule state and geometry; Accum is energy and temperature
+// sums and the histories built from them.
+#if defined(REACTOR_PRECISION_DOUBLE)
+using Real  = double;
+using Accum = double;
+#define REACTOR_PRECISION_NAME "double"
+#elif defined(REACTOR_PRECISION_MIXED)
+using Real  = float;
+using Accum = double;
+#define REACTOR_PRECISION_NAME "mixed"
+#else
+using Real  = float;
+using Accum = float;
+#define REACTOR_PRECISION_NAME "float"
+#endif
+
+#endif // PRECISION_HPP
@@ -0,0 +1,157 @@
+// ReactionStats.cpp
+#include "ReactionStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+void ReactionStats::Counts::add(const Counts& other, int sign) {
+    for (int a = 0; a < TYPES; ++a) {
+        for (int b = 0; b < TYPES; ++b) {
+            detected[a][b] += sign * other.detected[a][b];
+            executed[a][b] += sign * other.executed[a][b];
+            deferred[a][b] += sign * other.deferred[a][b];
+            rejected[a][b] += sign * other.rejected[a][b];
+        }
+    }
+}
+
+long long ReactionStats::Counts::totalExecuted() const {
+    long long total = 0;
+    for (int a = 0; a < TYPES; ++a) {
+        for (int b = 0; b < TYPES; ++b) {
+            total += executed[a][b];
+        }
+    }
+    return total;
+}
+
+long long ReactionStats::Counts::totalDeferred() const {
+    long long total = 0;
+    for (int a = 0; a < TYPES; ++a) {
+        for (int b = 0; b < TYPES; ++b) {
+            total += deferred[a][b];
+        }
+    }
+    return total;
+}
+
+long long ReactionStats::Counts::totalRejected() const {
+    long long total = 0;
+    for (int a = 0; a < TYPES; ++a) {
+        for (int b = 0; b < TYPES; ++b) {
+            total += rejected[a][b];
+        }
+    }
+    return total;
+}
+
+ReactionStats::ReactionStats() {
+    configureHeatMap(heat_cols_, heat_rows_);
+}
+
+void ReactionStats::setBounds(float x, float y, float width, float height) {
+    bounds_x_ = x;
+    bounds_y_ = y;
+    bounds_w_ = std::max(width,  1e-3f);
+    bounds_h_ = std::max(height, 1e-3f);
+}
+
+void ReactionStats::configureHeatMap(int cols, int rows) {
+    heat_cols_ = std::max(1, cols);
+    heat_rows_ = std::max(1, rows);
+    heat_recent_.assign(static_cast<size_t>(heat_cols_) * heat_rows_, 0.f);
+    heat_total_ .assign(static_cast<size_t>(heat_cols_) * heat_rows_, 0);
+    step_cells_.clear();
+    last_cells_.clear();
+}
+
+void ReactionStats::reset() {
+    step_ = last_step_ = window_sum_ = total_ = Counts();
+    window_.clear();
+    window_time_ = 0;
+    std::fill(heat_recent_.begin(), heat_recent_.end(), 0.f);
+    std::fill(heat_total_ .begin(), heat_total_ .end(), 0);
+    step_cells_.clear();
+    last_cells_.clear();
+}
+
+void ReactionStats::recordDetected(int type1, int type2) {
+    step_.detected[type1][type2]++;
+}
+
+void ReactionStats::recordExecuted(int type1, int type2, float x, float y) {
+    step_.executed[type1][type2]++;
+
+    int cx = std::clamp(static_cast<int>((x - bounds_x_) / bounds_w_ * heat_cols_), 0, heat_cols_ - 1);
+    int cy = std::clamp(static_cast<int>((y - bounds_y_) / bounds_h_ * heat_rows_), 0, heat_rows_ - 1);
+    size_t cell = static_cast<size_t>(cy) * heat_cols_ + cx;
+    heat_recent_[cell] += 1.f;
+    heat_total_ [cell] += 1;
+    step_cells_.push_back(static_cast<std::uint32_t>(cell));
+}
+
+void ReactionStats::endStep(float dt) {
+    last_step_ = step_;
+    total_.add(step_, 1);
+
+    window_.push_back({dt, step_});
+    window_sum_.add(step_, 1);
+    window_time_ += dt;
+    while (window_.size() > 1 && window_time_ - window_.front().dt >= 1.0f) {
+        window_sum_.add(window_.front().counts, -1);
+        window_time_ -= window_.front().dt;
+        window_.pop_front();
+    }
+
+    float decay = std::exp(-dt);
+    for (auto& cell : heat_recent_) {
+        cell *= decay;
+    }
+
+    step_ = Counts();
+    last_cells_.swap(step_cells_);
+    step_cells_.clear();
+}
+
+void ReactionStats::replayStep(const Counts& counts, const std::vector<std::uint32_t>& cells, float dt) {
+    step_ = counts;
+    for (std::uint32_t cell : cells) {
+        heat_recent_[cell] += 1.f;
+        heat_total_ [cell] += 1;
+    }
+    step_cells_ = cells;
+    endStep(dt);
+}
+
+const char* ReactionStats::pairName(int type1, int type2) {
+    static const char* NAMES[TYPES][TYPES] = {
+        {"round-round",  "round-square"},
+        {"square-round", "square-square"}
+    };
+    return NAMES[type1][type2];
+}
+
+void ReactionStats::writeCsv(std::ostream& out) const {
+    out << "pair,detected_step,executed_step,detected_1s,executed_1s,detected_total,executed_total,"
+           "deferred_total,rejected_total\n";
+    for (int a = 0; a < TYPES; ++a) {
+        for (int b = 0; b < TYPES; ++b) {
+            out << pairName(a, b)              << ','
+                << last_step_.detected[a][b]  << ','
+                << last_step_.executed[a][b]  << ','
+                << window_sum_.detected[a][b] << ','
+                << window_sum_.executed[a][b] << ','
+                << total_.detected[a][b]      << ','
+                << total_.executed[a][b]      << ','
+                << total_.deferred[a][b]      << ','
+                << total_.rejected[a][b]      << '\n';
+        }
+    }
+
+    out << "\nheat_map_total," << heat_cols_ << 'x' << heat_rows_ << '\n';
+    for (int y = 0; y < heat_rows_; ++y) {
+        for (int x = 0; x < heat_cols_; ++x) {
+            out << (x ? "," : "") << heat_total_[static_cast<size_t>(y) * heat_cols_ + x];
+        }
+        out << '\n';
+    }
+}
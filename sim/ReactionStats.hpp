@@ -0,0 +1,84 @@
+// ReactionStats.hpp
+#ifndef REACTION_STATS_HPP
+#define REACTION_STATS_HPP
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+// Collision and reaction counters per reactionTable entry, for the last
+// step and for a sliding one-second window, plus a coarse grid of where
+// reactions happened (decaying with a one-second time constant, and as
+// running totals for export).
+class ReactionStats {
+public:
+    static const int TYPES = 2;
+
+    struct Counts {
+        long long detected[TYPES][TYPES] = {{0, 0}, {0, 0}};
+        long long executed[TYPES][TYPES] = {{0, 0}, {0, 0}};
+        long long deferred[TYPES][TYPES] = {{0, 0}, {0, 0}};
+        long long rejected[TYPES][TYPES] = {{0, 0}, {0, 0}};
+
+        void add     (const Counts& other, int sign);
+        long long totalExecuted() const;
+        long long totalDeferred() const;
+        long long totalRejected() const;
+    };
+
+private:
+    struct WindowEntry {
+        float  dt;
+        Counts counts;
+    };
+
+    Counts step_;
+    Counts last_step_;
+    Counts window_sum_;
+    Counts total_;
+    std::deque<WindowEntry> window_;
+    float  window_time_ = 0;
+
+    int   heat_cols_ = 32;
+    int   heat_rows_ = 24;
+    float bounds_x_ = 0, bounds_y_ = 0, bounds_w_ = 1, bounds_h_ = 1;
+    std::vector<float>     heat_recent_;
+    std::vector<long long> heat_total_;
+    std::vector<std::uint32_t> step_cells_;   // heat map cells hit this step
+    std::vector<std::uint32_t> last_cells_;
+
+public:
+    ReactionStats();
+
+    void setBounds(float x, float y, float width, float height);
+    void configureHeatMap(int cols, int rows);
+    void reset();
+
+    void recordDetected(int type1, int type2);
+    void recordExecuted(int type1, int type2, float x, float y);
+    // Held back by the reaction budget or the population cap.
+    void recordDeferred(int type1, int type2) { step_.deferred[type1][type2]++; }
+    void recordRejected(int type1, int type2) { step_.rejected[type1][type2]++; }
+    // Closes the current step: rolls it into the window and decays the map.
+    void endStep(float dt);
+    // Redoes a step from its getLastStep() counts and getLastStepCells(),
+    // ending in the same state as recording it did.
+    void replayStep(const Counts& counts, const std::vector<std::uint32_t>& cells, float dt);
+
+    const Counts& getLastStep  () const { return last_step_; }
+    const Counts& getLastSecond() const { return window_sum_; }
+    const Counts& getTotal     () const { return total_; }
+    const std::vector<std::uint32_t>& getLastStepCells() const { return last_cells_; }
+
+    int getHeatCols() const { return heat_cols_; }
+    int getHeatRows() const { return heat_rows_; }
+    const std::vector<float>&     getRecentHeatMap() const { return heat_recent_; }
+    const std::vector<long long>& getTotalHeatMap () const { return heat_total_; }
+
+    void writeCsv(std::ostream& out) const;
+
+    static const char* pairName(int type1, int type2);
+};
+
+#endif // REACTION_STATS_HPP
@@ -1,65 +1,62 @@
 // Reactor.cpp
 #include "Reactor.hpp"
+#include "SharedStateExporter.hpp"
+#include "StatsArchive.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
-Molecule::Molecule(MoleculeType t, float x, float y, float vx, float vy, float mass) 
-    : type(t), position(x, y, 0), velocity(vx, vy, 0), mass(mass) {}
+Molecule::Molecule(MoleculeType t, Real x, Real y, Real vx, Real vy, Real mass) 
+    : type(t), position(x, y), velocity(vx, vy), stepStart(x, y), mass(mass) {}
 
-void Molecule::setPosition(float x, float y) { 
-    position = Vector2f(x, y, 0); 
+void Molecule::setPosition(Real x, Real y) { 
+    position = Vector2f(x, y); 
 }
 
-void Molecule::setVelocity(float vx, float vy) { 
-    velocity = Vector2f(vx, vy, 0); 
+void Molecule::setVelocity(Real vx, Real vy) { 
+    velocity = Vector2f(vx, vy); 
 }
 
-RoundMolecule::RoundMolecule(float x, float y, float vx, float vy, float radius, float mass) 
+RoundMolecule::RoundMolecule(Real x, Real y, Real vx, Real vy, Real radius, Real mass) 
     : Molecule(MoleculeType::Round, x, y, vx, vy, mass), radius(radius) {}
 
 Vector2f RoundMolecule::getSize() const {
-    return Vector2f(radius * 2, radius * 2, 0);
+    return Vector2f(radius * 2, radius * 2);
 }
 
-void RoundMolecule::update(float dt) {
-    position = position + velocity * dt;
+void RoundMolecule::update(Real dt) {
+    position.moveBy(velocity, dt);
 }
 
 bool RoundMolecule::collidesWith(const Molecule& other) const {
     if (other.getType() == MoleculeType::Round) {
-        Vector2f pos1 = getPosition();
-        Vector2f pos2 = other.getPosition();
-        float distance = pos1 << pos2;
-        const RoundMolecule* roundOther = dynamic_cast<const RoundMolecule*>(&other);
-        if (roundOther) {
-            return distance <= (radius + roundOther->radius);
-        }
-        return false;
+        Real contact = radius + static_cast<const RoundMolecule&>(other).radius;
+        return position.distanceSquared(other.getPosition()) <= contact * contact;
     } else {
         Vector2f circleCenter = getPosition();
         Vector2f squareSize = other.getSize();
         Vector2f squarePos = other.getPosition();
         
-        float closestX = std::max(squarePos.getX() - squareSize.getX()/2, 
+        Real closestX = std::max(squarePos.getX() - squareSize.getX()/2, 
                                 std::min(circleCenter.getX(), squarePos.getX() + squareSize.getX()/2));
-        float closestY = std::max(squarePos.getY() - squareSize.getY()/2, 
+        Real closestY = std::max(squarePos.getY() - squareSize.getY()/2, 
                                 std::min(circleCenter.getY(), squarePos.getY() + squareSize.getY()/2));
         
-        float dx = circleCenter.getX() - closestX;
-        float dy = circleCenter.getY() - closestY;
+        Real dx = circleCenter.getX() - closestX;
+        Real dy = circleCenter.getY() - closestY;
         return (dx*dx + dy*dy) <= (radius * radius);
     }
 }
 
-SquareMolecule::SquareMolecule(float x, float y, float vx, float vy, float size, float mass) 
+SquareMolecule::SquareMolecule(Real x, Real y, Real vx, Real vy, Real size, Real mass) 
     : Molecule(MoleculeType::Square, x, y, vx, vy, mass), size(size) {}
 
 Vector2f SquareMolecule::getSize() const {
-    return Vector2f(size, size, 0);
+    return Vector2f(size, size);
 }
 
-void SquareMolecule::update(float dt) {
-    position = position + velocity * dt;
+void SquareMolecule::update(Real dt) {
+    position.moveBy(velocity, dt);
 }
 
 bool SquareMolecule::collidesWith(const Molecule& other) const {
@@ -78,8 +75,8 @@ bool SquareMolecule::collidesWith(const Molecule& other) const {
     }
 }
 
-Reactor::Reactor(float x, float y, float width, float height, float wallThick, 
-                 float molRadius, float sqSize, float molSpeed)
+Reactor::Reactor(Real x, Real y, Real width, Real height, Real wallThick, 
+                 Real molRadius, Real sqSize, Real molSpeed)
     : reactorX(x), reactorY(y), reactorWidth(width), reactorHeight(height),
       wallThickness(wallThick), moleculeRadius(molRadius), 
       squareSize(sqSize), moleculeSpeed(molSpeed),
@@ -88,57 +85,111 @@ Reactor::Reactor(float x, float y, float width, float height, float wallThick,
     reactionTable[0][1] = &Reactor::handleRoundSquareCollision;
     reactionTable[1][0] = &Reactor::handleRoundSquareCollision;
     reactionTable[1][1] = &Reactor::handleSquareSquareCollision;
+
+    speedHistogram.configure(32, 4 * molSpeed);
+}
+
+Reactor::~Reactor() = default;
+
+void Reactor::seed(unsigned int value) {
+    rng.seed(value);
 }
 
 void Reactor::increaseLeftWallTemperature() {
-    leftWallTemperature = std::min(leftWallTemperature + 0.2f, 3.0f); 
+    leftWallTemperature = std::min<Real>(leftWallTemperature + 0.2f, 3.0f); 
 }
 
 void Reactor::decreaseLeftWallTemperature() {
-    leftWallTemperature = std::max(leftWallTemperature - 0.2f, 0.2f); 
+    leftWallTemperature = std::max<Real>(leftWallTemperature - 0.2f, 0.2f); 
+}
+
+void Reactor::setLeftWallTemperature(Real temperature) {
+    leftWallTemperature = std::clamp<Real>(temperature, 0.2f, 3.0f);
 }
 
 void Reactor::addRoundMolecule() {
-    float x = reactorX + wallThickness + moleculeRadius +
-              (reactorWidth - 2 * wallThickness - 2 * moleculeRadius) * (float)rng() / rng.max();
-    float y = reactorY + wallThickness + moleculeRadius +
-              (reactorHeight - 2 * wallThickness - 2 * moleculeRadius) * (float)rng() / rng.max();
-    float vx = distVel(rng);
-    float vy = distVel(rng);
-    molecules.push_back(std::make_unique<RoundMolecule>(x, y, vx, vy, moleculeRadius));
+    if (atPopulationCap()) return;
+    spatialGridDirty = true;
+    Real x = reactorX + wallThickness + moleculeRadius +
+              (reactorWidth - 2 * wallThickness - 2 * moleculeRadius) * (Real)rng() / rng.max();
+    Real y = reactorY + wallThickness + moleculeRadius +
+              (reactorHeight - 2 * wallThickness - 2 * moleculeRadius) * (Real)rng() / rng.max();
+    Real vx = distVel(rng);
+    Real vy = distVel(rng);
+    addMolecule(std::make_unique<RoundMolecule>(x, y, vx, vy, moleculeRadius));
 }
 
 void Reactor::addSquareMolecule() {
-    float x = reactorX + wallThickness + squareSize/2 +
-              (reactorWidth - 2 * wallThickness - squareSize) * (float)rng() / rng.max();
-    float y = reactorY + wallThickness + squareSize/2 +
-              (reactorHeight - 2 * wallThickness - squareSize) * (float)rng() / rng.max();
-    float vx = distVel(rng);
-    float vy = distVel(rng);
-    molecules.push_back(std::make_unique<SquareMolecule>(x, y, vx, vy, squareSize, 2.0f));
+    if (atPopulationCap()) return;
+    spatialGridDirty = true;
+    Real x = reactorX + wallThickness + squareSize/2 +
+              (reactorWidth - 2 * wallThickness - squareSize) * (Real)rng() / rng.max();
+    Real y = reactorY + wallThickness + squareSize/2 +
+              (reactorHeight - 2 * wallThickness - squareSize) * (Real)rng() / rng.max();
+    Real vx = distVel(rng);
+    Real vy = distVel(rng);
+    addMolecule(std::make_unique<SquareMolecule>(x, y, vx, vy, squareSize, 2.0f));
+}
+
+void Reactor::addRoundMolecules(int count) {
+    if (count <= 0) return;
+    molecules.reserve(molecules.size() + count);
+    for (int i = 0; i < count; ++i) {
+        addRoundMolecule();
+    }
 }
 
-void Reactor::addSquareMoleculeAt(float x, float y, float mass) {
-    float vx = distVel(rng);
-    float vy = distVel(rng);
-    molecules.push_back(std::make_unique<SquareMolecule>(x, y, vx, vy, squareSize, mass));
+void Reactor::addSquareMolecules(int count) {
+    if (count <= 0) return;
+    molecules.reserve(molecules.size() + count);
+    for (int i = 0; i < count; ++i) {
+        addSquareMolecule();
+    }
 }
 
-void Reactor::addRoundMoleculeAt(float x, float y, float vx, float vy) {
-    molecules.push_back(std::make_unique<RoundMolecule>(x, y, vx, vy, moleculeRadius));
+void Reactor::addMolecule(std::unique_ptr<Molecule> mol) {
+    mol->setId(nextMoleculeId++);
+    molecules.push_back(std::move(mol));
+    idIndexDirty = true;
+}
+
+void Reactor::removeLastMolecules(int count) {
+    spatialGridDirty = true;
+    size_t n = std::min(molecules.size(), static_cast<size_t>(std::max(0, count)));
+    molecules.erase(molecules.end() - n, molecules.end());
+    idIndexDirty = true;
+}
+
+void Reactor::addSquareMoleculeAt(Real x, Real y, Real mass) {
+    spatialGridDirty = true;
+    Real vx = distVel(rng);
+    Real vy = distVel(rng);
+    addMolecule(std::make_unique<SquareMolecule>(x, y, vx, vy, squareSize, mass));
+}
+
+void Reactor::addRoundMoleculeAt(Real x, Real y, Real vx, Real vy, Real mass) {
+    spatialGridDirty = true;
+    addMolecule(std::make_unique<RoundMolecule>(x, y, vx, vy, moleculeRadius, mass));
 }
 
 void Reactor::removeLastMolecule() {
+    spatialGridDirty = true;
     if (!molecules.empty()) {
         molecules.pop_back();
+        idIndexDirty = true;
     }
 }
 
-void Reactor::resize(float newWidth) {
+void Reactor::resize(Real newWidth) {
+    spatialGridDirty = true;
     reactorWidth = newWidth;
 }
 
-void Reactor::update(float dt) {
+void Reactor::update(Real dt) {
+    applyCommands();
+
+    spatialGridDirty = true;
+    lastDt = dt;
     hitTimer += dt;
     if (hitTimer >= 1.0f) {
         hitTimer = 0;
@@ -148,20 +199,374 @@ void Reactor::update(float dt) {
     updateMoleculePositions(dt);
     handleCollisions();
     processRemovals();
+    maybeReorder();
     updateStatistics();
+
+    reactionStats.endStep(dt);
+
+    stepCount++;
+    simTime += dt;
+    if (sharedExport) {
+        sharedExport->publish(*this);
+    }
+    for (auto& observer : stepObservers) {
+        observer(*this);
+    }
+    scratch.reset();
 }
 
-void Reactor::handleCollisions() {
-    std::vector<std::pair<size_t, size_t>> collisions;
-    
+void Reactor::saveMolecules(std::vector<MoleculeState>& out) const {
+    out.resize(molecules.size());
     for (size_t i = 0; i < molecules.size(); ++i) {
-        if (!molecules[i]) continue;
-        for (size_t j = i + 1; j < molecules.size(); ++j) {
-            if (molecules[j] && molecules[i]->collidesWith(*molecules[j])) {
-                collisions.emplace_back(i, j);
-                break; 
+        const Molecule& mol = *molecules[i];
+        MoleculeState& state = out[i];
+        state.id   = mol.getId();
+        state.type = mol.getType();
+        state.x    = mol.getPosition().x;
+        state.y    = mol.getPosition().y;
+        state.vx   = mol.getVelocity().x;
+        state.vy   = mol.getVelocity().y;
+        state.mass = mol.getMass();
+        state.size = state.type == MoleculeType::Round ? static_cast<const RoundMolecule&>(mol).getRadius()
+                                                       : static_cast<const SquareMolecule&>(mol).getSizeValue();
+    }
+}
+
+void Reactor::loadMolecules(const std::vector<MoleculeState>& states) {
+    molecules.clear();
+    molecules.reserve(states.size());
+    for (const MoleculeState& state : states) {
+        if (state.type == MoleculeType::Round) {
+            molecules.push_back(std::make_unique<RoundMolecule>(state.x, state.y, state.vx, state.vy, state.size, state.mass));
+        } else {
+            molecules.push_back(std::make_unique<SquareMolecule>(state.x, state.y, state.vx, state.vy, state.size, state.mass));
+        }
+        molecules.back()->setId(state.id);
+    }
+    moleculesToRemove.clear();
+    removalMarks.clear();
+    spatialGridDirty = true;
+    idIndexDirty = true;
+}
+
+ReactorScalars Reactor::getScalars() const {
+    ReactorScalars scalars;
+    scalars.stepCount               = stepCount;
+    scalars.simTime                 = simTime;
+    scalars.rightWallHitsTotal      = rightWallHitsTotal;
+    scalars.lastReorder             = lastReorder;
+    scalars.rightWallHitsLastSecond = rightWallHitsLastSecond;
+    scalars.hitTimer                = hitTimer;
+    scalars.leftWallTemperature     = leftWallTemperature;
+    scalars.lastDt                  = lastDt;
+    scalars.reactorWidth            = reactorWidth;
+    scalars.nextMoleculeId          = nextMoleculeId;
+    return scalars;
+}
+
+void Reactor::setScalars(const ReactorScalars& scalars) {
+    stepCount               = scalars.stepCount;
+    simTime                 = scalars.simTime;
+    rightWallHitsTotal      = scalars.rightWallHitsTotal;
+    lastReorder             = scalars.lastReorder;
+    rightWallHitsLastSecond = scalars.rightWallHitsLastSecond;
+    hitTimer                = scalars.hitTimer;
+    leftWallTemperature     = scalars.leftWallTemperature;
+    lastDt                  = scalars.lastDt;
+    reactorWidth            = scalars.reactorWidth;
+    nextMoleculeId          = std::max(nextMoleculeId, scalars.nextMoleculeId);
+    spatialGridDirty = true;
+}
+
+void Reactor::dropHistorySamples(size_t count) {
+    auto drop = [count](auto& history) {
+        for (size_t k = 0; k < count && !history.empty(); ++k) history.pop_back();
+    };
+    drop(moleculeHistory);
+    drop(roundMoleculeHistory);
+    drop(squareMoleculeHistory);
+    drop(energyHistory);
+    drop(temperatureHistory);
+}
+
+void Reactor::appendHistorySample(const StatsSample& sample) {
+    moleculeHistory.      push_back(sample.total);
+    roundMoleculeHistory. push_back(sample.round);
+    squareMoleculeHistory.push_back(sample.square);
+    energyHistory.        push_back(sample.energy);
+    temperatureHistory.   push_back(sample.temperature);
+    if (historyLimit > 0) {
+        setHistoryLimit(historyLimit);
+    }
+}
+
+bool Reactor::enableSharedExport(const std::string& name, size_t capacity, size_t slots) {
+    auto exporter = std::make_unique<SharedStateExporter>();
+    if (!exporter->open(name, capacity, slots)) return false;
+    sharedExport = std::move(exporter);
+    return true;
+}
+
+void Reactor::disableSharedExport() {
+    sharedExport.reset();
+}
+
+const SpatialGrid& Reactor::getSpatialGrid() const {
+    if (spatialGridDirty) {
+        // Aim for a handful of molecules per cell.
+        Real area = reactorWidth * reactorHeight;
+        Real cell = std::sqrt(area * 4.f / std::max<size_t>(1, molecules.size()));
+        spatialGrid.build(molecules, reactorX, reactorY, reactorWidth, reactorHeight,
+                          std::max(cell, 2 * squareSize));
+        spatialGridDirty = false;
+    }
+    return spatialGrid;
+}
+
+size_t Reactor::findNearest(Real x, Real y, Real maxDistance) const {
+    const SpatialGrid& grid = getSpatialGrid();
+    if (grid.size() == 0) return NO_MOLECULE;
+
+    Vector2f point(x, y);
+    size_t best = NO_MOLECULE;
+    Real bestSq = maxDistance * maxDistance;
+    int cx = grid.cellX(x), cy = grid.cellY(y);
+
+    for (int ring = 0; ring <= grid.maxRing(cx, cy); ++ring) {
+        grid.forEachInRing(cx, cy, ring, [&](size_t i) {
+            Real distSq = molecules[i]->getPosition().distanceSquared(point);
+            if (distSq <= bestSq) {
+                bestSq = distSq;
+                best   = i;
+            }
+        });
+        Real reach = ring * grid.getCellSize();
+        if (reach * reach > bestSq) break;
+    }
+    return best;
+}
+
+void Reactor::findNearestK(Real x, Real y, size_t k, std::vector<size_t>& out) const {
+    out.clear();
+    const SpatialGrid& grid = getSpatialGrid();
+    if (grid.size() == 0 || k == 0) return;
+
+    // Max-heap on distance holding the k best so far.
+    Vector2f point(x, y);
+    std::vector<std::pair<Real, size_t>> heap;
+    heap.reserve(k + 1);
+    int cx = grid.cellX(x), cy = grid.cellY(y);
+
+    for (int ring = 0; ring <= grid.maxRing(cx, cy); ++ring) {
+        grid.forEachInRing(cx, cy, ring, [&](size_t i) {
+            Real distSq = molecules[i]->getPosition().distanceSquared(point);
+            if (heap.size() < k) {
+                heap.emplace_back(distSq, i);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (distSq < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = std::make_pair(distSq, i);
+                std::push_heap(heap.begin(), heap.end());
             }
+        });
+        Real reach = ring * grid.getCellSize();
+        if (heap.size() == k && reach * reach > heap.front().first) break;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto& entry : heap) {
+        out.push_back(entry.second);
+    }
+}
+
+void Reactor::findInRect(Real left, Real top, Real right, Real bottom, std::vector<size_t>& out) const {
+    out.clear();
+    getSpatialGrid().forEachInRect(left, top, right, bottom, [&](size_t i) {
+        Vector2f pos = molecules[i]->getPosition();
+        if (pos.x >= left && pos.x <= right && pos.y >= top && pos.y <= bottom) {
+            out.push_back(i);
+        }
+    });
+}
+
+void Reactor::findInCircle(Real x, Real y, Real radius, std::vector<size_t>& out) const {
+    out.clear();
+    Vector2f point(x, y);
+    getSpatialGrid().forEachInRect(x - radius, y - radius, x + radius, y + radius, [&](size_t i) {
+        if (molecules[i]->getPosition().distanceSquared(point) <= radius * radius) {
+            out.push_back(i);
+        }
+    });
+}
+
+size_t Reactor::countInCircle(Real x, Real y, Real radius) const {
+    size_t count = 0;
+    Vector2f point(x, y);
+    getSpatialGrid().forEachInRect(x - radius, y - radius, x + radius, y + radius, [&](size_t i) {
+        if (molecules[i]->getPosition().distanceSquared(point) <= radius * radius) {
+            count++;
+        }
+    });
+    return count;
+}
+
+size_t Reactor::findById(std::uint32_t id) const {
+    const std::uint32_t NONE = static_cast<std::uint32_t>(-1);
+
+    // One slot per id ever issued: 4 bytes each, rebuilt in a linear pass.
+    if (idIndexDirty) {
+        indexOfId.assign(nextMoleculeId, NONE);
+        for (size_t i = 0; i < molecules.size(); ++i) {
+            indexOfId[molecules[i]->getId()] = static_cast<std::uint32_t>(i);
         }
+        idIndexDirty = false;
+    }
+    if (id >= indexOfId.size() || indexOfId[id] == NONE) return NO_MOLECULE;
+    return indexOfId[id];
+}
+
+void Reactor::setReorderPolicy(int interval, float minLocality) {
+    reorderInterval = std::max(0, interval);
+    reorderLocality = std::clamp(minLocality, 0.f, 1.f);
+}
+
+namespace {
+
+// Spreads the low 16 bits of v over the even bits of the result.
+std::uint32_t spreadBits(std::uint32_t v) {
+    v &= 0xffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+}
+
+void Reactor::reorderMolecules() {
+    if (molecules.size() < 2) return;
+
+    Real scaleX = 65535 / std::max<Real>(reactorWidth,  1);
+    Real scaleY = 65535 / std::max<Real>(reactorHeight, 1);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> keys(molecules.size());
+    jobs.parallelFor(molecules.size(), 4096, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            Vector2f pos = molecules[i]->getPosition();
+            auto gx = static_cast<std::uint32_t>(std::clamp<Real>((pos.x - reactorX) * scaleX, 0, 65535));
+            auto gy = static_cast<std::uint32_t>(std::clamp<Real>((pos.y - reactorY) * scaleY, 0, 65535));
+            keys[i] = std::make_pair(spreadBits(gx) | (spreadBits(gy) << 1), static_cast<std::uint32_t>(i));
+        }
+    });
+    std::sort(keys.begin(), keys.end());
+
+    // Copy into fresh allocations in curve order so the objects themselves,
+    // not just the pointers, end up next to their spatial neighbours. The
+    // old ones stay alive until the copy is done, so the allocator cannot
+    // hand their scattered slots back.
+    std::vector<std::unique_ptr<Molecule>> sorted;
+    sorted.reserve(molecules.size());
+    for (const auto& key : keys) {
+        const Molecule& mol = *molecules[key.second];
+        if (mol.getType() == MoleculeType::Round) {
+            sorted.push_back(std::make_unique<RoundMolecule>(static_cast<const RoundMolecule&>(mol)));
+        } else {
+            sorted.push_back(std::make_unique<SquareMolecule>(static_cast<const SquareMolecule&>(mol)));
+        }
+    }
+    molecules.swap(sorted);
+
+    spatialGridDirty = true;
+    idIndexDirty = true;
+    lastReorder = stepCount;
+}
+
+float Reactor::measureLocality() const {
+    if (molecules.size() < 2) return 1.f;
+
+    // "Neighbours" are within two cells of the grid's usual cell size.
+    Real cell = std::sqrt(reactorWidth * reactorHeight * 4.f / molecules.size());
+    Real reachSq = 4 * cell * cell;
+
+    size_t near = 0;
+    for (size_t i = 0; i + 1 < molecules.size(); ++i) {
+        if (molecules[i]->getPosition().distanceSquared(molecules[i + 1]->getPosition()) <= reachSq) {
+            near++;
+        }
+    }
+    return static_cast<float>(near) / (molecules.size() - 1);
+}
+
+void Reactor::maybeReorder() {
+    const int LOCALITY_CHECK_INTERVAL = 32;
+
+    long long since = stepCount - lastReorder;
+    if (reorderInterval > 0 && since >= reorderInterval) {
+        reorderMolecules();
+    } else if (reorderLocality > 0 && since > 0 && since % LOCALITY_CHECK_INTERVAL == 0 &&
+               measureLocality() < reorderLocality) {
+        reorderMolecules();
+    }
+}
+
+void Reactor::handleCollisions() {
+    const size_t NONE = static_cast<size_t>(-1);
+    const size_t DETECT_GRAIN = 64;
+
+    // Finding each molecule's first partner only reads, so it is split
+    // across workers; the pairs are then collected in index order.
+    collisionPartner.assign(molecules.size(), NONE);
+    jobs.parallelFor(molecules.size(), DETECT_GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!molecules[i]) continue;
+            for (size_t j = i + 1; j < molecules.size(); ++j) {
+                if (molecules[j] && collides(*molecules[i], *molecules[j])) {
+                    collisionPartner[i] = j;
+                    break;
+                }
+            }
+        }
+    });
+
+    using IndexPair = std::pair<size_t, size_t>;
+    ScratchVector<IndexPair> collisions{ArenaAllocator<IndexPair>(scratch)};
+
+    // Reactions held back earlier go first, oldest first, as long as both
+    // molecules are still around; the pair need not touch any more.
+    ScratchVector<IndexPair> carried{ArenaAllocator<IndexPair>(scratch)};
+    for (const MoleculePair& pair : deferredPairs) {
+        size_t i = findById(pair.first);
+        size_t j = findById(pair.second);
+        if (i == NO_MOLECULE || j == NO_MOLECULE) continue;
+        collisions.emplace_back(std::min(i, j), std::max(i, j));
+    }
+    deferredPairs.clear();
+    carried.assign(collisions.begin(), collisions.end());
+    std::sort(carried.begin(), carried.end());
+
+    collisions.reserve(collisions.size() + molecules.size() - std::count(collisionPartner.begin(), collisionPartner.end(), NONE));
+    for (size_t i = 0; i < collisionPartner.size(); ++i) {
+        size_t j = collisionPartner[i];
+        if (j == NONE) continue;
+        reactionStats.recordDetected(static_cast<int>(molecules[i]->getType()),
+                                     static_cast<int>(molecules[j]->getType()));
+        if (!std::binary_search(carried.begin(), carried.end(), IndexPair(i, j))) {
+            collisions.emplace_back(i, j);
+        }
+    }
+
+    if (reactionBudget > 0 && collisions.size() > static_cast<size_t>(reactionBudget)) {
+        for (size_t k = reactionBudget; k < collisions.size(); ++k) {
+            const Molecule& a = *molecules[collisions[k].first];
+            const Molecule& b = *molecules[collisions[k].second];
+            reactionStats.recordDeferred(static_cast<int>(a.getType()), static_cast<int>(b.getType()));
+            deferredPairs.emplace_back(a.getId(), b.getId());
+        }
+        collisions.resize(reactionBudget);
+        std::sort(collisions.begin(), collisions.end());
+    } else if (!carried.empty()) {
+        std::sort(collisions.begin(), collisions.end());
     }
     
     for (auto it = collisions.rbegin(); it != collisions.rend(); ++it) {
@@ -169,6 +574,82 @@ void Reactor::handleCollisions() {
     }
 }
 
+namespace {
+
+// Radius of the circle around the molecule, corners included.
+Real boundingRadius(const Molecule& mol) {
+    Real half = mol.getSize().getX() / 2;
+    return mol.getType() == MoleculeType::Square ? half * std::sqrt(Real(2)) : half;
+}
+
+// Whether start + s * move, s in [0, 1], comes within radius of the origin.
+bool sweepHitsCircle(Vector2f start, Vector2f move, Real radius) {
+    Real moveSq = move.lengthSquared();
+    Real s = moveSq > 0 ? std::clamp<Real>(-start.dot(move) / moveSq, 0, 1) : 0;
+    return start.addScaled(move, s).lengthSquared() <= radius * radius;
+}
+
+// Whether start + s * move, s in [0, 1], enters the box |x| <= halfX, |y| <= halfY.
+bool sweepHitsBox(Vector2f start, Vector2f move, Real halfX, Real halfY) {
+    Real enter = 0, leave = 1;
+    const Real from[2] = {start.getX(), start.getY()};
+    const Real by  [2] = {move.getX(),  move.getY()};
+    const Real half[2] = {halfX, halfY};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (by[axis] == 0) {
+            if (std::abs(from[axis]) > half[axis]) return false;
+            continue;
+        }
+        Real t1 = (-half[axis] - from[axis]) / by[axis];
+        Real t2 = ( half[axis] - from[axis]) / by[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        enter = std::max(enter, t1);
+        leave = std::min(leave, t2);
+        if (enter > leave) return false;
+    }
+    return true;
+}
+
+}
+
+bool Reactor::collides(const Molecule& a, const Molecule& b) const {
+    if (a.collidesWith(b)) return true;
+    if (collisionMode != CollisionMode::Swept) return false;
+
+    // Both molecules move in a straight line from where the step began to
+    // where it ended; work in b's frame, so only a moves.
+    Vector2f relStart = a.getStepStart() - b.getStepStart();
+    Vector2f relMove  = (a.getPosition() - b.getPosition()) - relStart;
+    if (relMove.lengthSquared() <= 0) return false;
+
+    // Broadphase on the bounding circles, then the shapes themselves: the
+    // circle around a square reaches past its sides.
+    if (!sweepHitsCircle(relStart, relMove, boundingRadius(a) + boundingRadius(b))) return false;
+
+    bool roundA = a.getType() == MoleculeType::Round;
+    bool roundB = b.getType() == MoleculeType::Round;
+    if (roundA && roundB) return true;
+
+    if (!roundA && !roundB) {
+        Real reach = (a.getSize().getX() + b.getSize().getX()) / 2;
+        return sweepHitsBox(relStart, relMove, reach, reach);
+    }
+
+    // Circle against square: sweep the centre against the square grown by
+    // the radius, corners rounded.
+    Real radius = (roundA ? a : b).getSize().getX() / 2;
+    Real half   = (roundA ? b : a).getSize().getX() / 2;
+    Vector2f start = roundA ? relStart : -relStart;
+    Vector2f move  = roundA ? relMove  : -relMove;
+    if (sweepHitsBox(start, move, half + radius, half) || sweepHitsBox(start, move, half, half + radius)) return true;
+    for (Real cx : {-half, half}) {
+        for (Real cy : {-half, half}) {
+            if (sweepHitsCircle(start - Vector2f(cx, cy), move, radius)) return true;
+        }
+    }
+    return false;
+}
+
 void Reactor::handleReaction(size_t i, size_t j) {
     if (i >= molecules.size() || j >= molecules.size() || i == j || !molecules[i] || !molecules[j]) return;
     
@@ -179,10 +660,67 @@ void Reactor::handleReaction(size_t i, size_t j) {
 
     Vector2f collisionPos = (pos1 + pos2) * 0.5f;
 
+    if (!reactionsEnabled) {
+        bounceApart(i, j);
+        return;
+    }
     ReactionHandler handler = reactionTable[type1][type2];
-    if (handler) {
-        handler(*this, i, j, collisionPos);
+    if (!handler) return;
+
+    // Only square-square reactions grow the population.
+    productLimit = static_cast<size_t>(-1);
+    if (populationCap > 0 && molecules[i]->getType() == MoleculeType::Square && molecules[j]->getType() == MoleculeType::Square) {
+        size_t population = molecules.size() - moleculesToRemove.size();
+        size_t products   = squareSquareProducts(i, j);
+        size_t freed      = !isMarkedForRemoval(i) + !isMarkedForRemoval(j);
+        if (population - freed + products > populationCap) {
+            switch (populationPolicy) {
+                case PopulationPolicy::Reject:
+                    reactionStats.recordRejected(static_cast<int>(type1), static_cast<int>(type2));
+                    bounceApart(i, j);
+                    return;
+                case PopulationPolicy::Defer:
+                    reactionStats.recordDeferred(static_cast<int>(type1), static_cast<int>(type2));
+                    deferredPairs.emplace_back(molecules[i]->getId(), molecules[j]->getId());
+                    return;
+                case PopulationPolicy::Merge:
+                    productLimit = std::max<size_t>(1, populationCap + freed - std::min(population, populationCap + freed - 1));
+                    break;
+            }
+        }
     }
+
+    reactionStats.setBounds(reactorX, reactorY, reactorWidth, reactorHeight);
+    reactionStats.recordExecuted(static_cast<int>(type1), static_cast<int>(type2),
+                                 collisionPos.getX(), collisionPos.getY());
+    handler(*this, i, j, collisionPos);
+    productLimit = static_cast<size_t>(-1);
+}
+
+size_t Reactor::squareSquareProducts(size_t i, size_t j) const {
+    int count = static_cast<int>(molecules[i]->getMass() + molecules[j]->getMass());
+    return static_cast<size_t>(std::clamp(count, 0, 50));
+}
+
+void Reactor::bounceApart(size_t i, size_t j) {
+    Molecule& a = *molecules[i];
+    Molecule& b = *molecules[j];
+
+    Vector2f normal = a.getPosition() - b.getPosition();
+    Real length = normal.length();
+    if (length <= 0) return;
+    normal *= 1.f / length;
+
+    Real approach = (a.getVelocity() - b.getVelocity()).dot(normal);
+    if (approach >= 0) return;
+
+    // Elastic exchange of the normal momentum.
+    Real ma = a.getMass(), mb = b.getMass();
+    Real impulse = 2 * approach / (ma + mb);
+    Vector2f va = a.getVelocity().addScaled(normal, -impulse * mb);
+    Vector2f vb = b.getVelocity().addScaled(normal,  impulse * ma);
+    a.setVelocity(va.getX(), va.getY());
+    b.setVelocity(vb.getX(), vb.getY());
 }
 
 void Reactor::handleRoundRoundCollision(Reactor& reactor, size_t i, size_t j, const Vector2f& collisionPos) {
@@ -199,18 +737,34 @@ void Reactor::handleRoundRoundCollision(Reactor& reactor, size_t i, size_t j, co
 }
 
 void Reactor::markForRemoval(size_t index) {
-    moleculesToRemove.push_back(index);
+    if (index >= removalMarks.size()) {
+        removalMarks.resize(std::max(index + 1, molecules.size()), 0);
+    }
+    if (!removalMarks[index]) {
+        removalMarks[index] = 1;
+        moleculesToRemove.push_back(index);
+    }
+}
+
+bool Reactor::isMarkedForRemoval(size_t index) const {
+    return index < removalMarks.size() && removalMarks[index];
 }
 
 void Reactor::processRemovals() {
-    std::sort(moleculesToRemove.rbegin(), moleculesToRemove.rend());
-    moleculesToRemove.erase(std::unique(moleculesToRemove.begin(), moleculesToRemove.end()), moleculesToRemove.end());
-    
-    for (auto index : moleculesToRemove) {
-        if (index < molecules.size()) {
-            molecules.erase(molecules.begin() + index);
+    if (moleculesToRemove.empty()) return;
+
+    // One compaction pass; the survivors keep their order.
+    size_t kept = 0;
+    for (size_t i = 0; i < molecules.size(); ++i) {
+        if (i < removalMarks.size() && removalMarks[i]) {
+            removalMarks[i] = 0;
+            continue;
         }
+        if (kept != i) molecules[kept] = std::move(molecules[i]);
+        kept++;
     }
+    molecules.resize(kept);
+    idIndexDirty = true;
     moleculesToRemove.clear();
 }
 
@@ -225,18 +779,18 @@ void Reactor::handleRoundSquareCollision(Reactor& reactor, size_t i, size_t j, c
         roundIdx  = i;
     }
 
-    float    squareMass = reactor.molecules[squareIdx]->getMass    ();
-    float    roundMass  = reactor.molecules[roundIdx ]->getMass    (); 
+    Real     squareMass = reactor.molecules[squareIdx]->getMass    ();
+    Real     roundMass  = reactor.molecules[roundIdx ]->getMass    (); 
     
     Vector2f squareVel  = reactor.molecules[squareIdx]->getVelocity();
     Vector2f roundVel   = reactor.molecules[roundIdx ]->getVelocity();
     
     Vector2f totalMomentum = squareVel * squareMass + roundVel * roundMass;
-    float newMass = squareMass + roundMass;
+    Real newMass = squareMass + roundMass;
     Vector2f newVel = totalMomentum * (1.0f / newMass); 
     
-    float x = reactor.molecules[squareIdx]->getPosition().getX();
-    float y = reactor.molecules[squareIdx]->getPosition().getY();
+    Real x = reactor.molecules[squareIdx]->getPosition().getX();
+    Real y = reactor.molecules[squareIdx]->getPosition().getY();
     
     reactor.markForRemoval(roundIdx);
     
@@ -244,12 +798,15 @@ void Reactor::handleRoundSquareCollision(Reactor& reactor, size_t i, size_t j, c
         squareIdx--;
     }
     
+    // The square absorbs the round one and keeps its identity.
+    std::uint32_t squareId = reactor.molecules[squareIdx]->getId();
     reactor.molecules[squareIdx] = std::make_unique<SquareMolecule>(x, y, newVel.getX(), newVel.getY(), reactor.squareSize, newMass);
+    reactor.molecules[squareIdx]->setId(squareId);
 }
 
 void Reactor::handleSquareSquareCollision(Reactor& reactor, size_t i, size_t j, const Vector2f& collisionPos) {
-    float mass1 = reactor.molecules[i]->getMass();
-    float mass2 = reactor.molecules[j]->getMass();
+    Real mass1 = reactor.molecules[i]->getMass();
+    Real mass2 = reactor.molecules[j]->getMass();
     
     int numNewMolecules = static_cast<int>(mass1 + mass2);
     if (numNewMolecules <= 0) return;
@@ -263,68 +820,88 @@ void Reactor::handleSquareSquareCollision(Reactor& reactor, size_t i, size_t j,
     reactor.markForRemoval(j);
     
     numNewMolecules = std::min(numNewMolecules, 50);
+
+    // Under a Merge cap the same mass leaves as fewer, heavier fragments.
+    int fragments = static_cast<int>(std::min<size_t>(numNewMolecules, reactor.productLimit));
+    Real fragmentMass = static_cast<Real>(numNewMolecules) / fragments;
     
-    float safeRadius = std::min(
+    Real safeRadius = std::min(
         std::min(reactor.reactorWidth - 2 * reactor.wallThickness, reactor.reactorHeight - 2 * reactor.wallThickness) / 2 - reactor.moleculeRadius,
-        numNewMolecules * reactor.moleculeRadius * 2.0f
+        fragments * reactor.moleculeRadius * 2.0f
     );
     
-    float maxX = reactor.reactorX + reactor.reactorWidth  - reactor.wallThickness - reactor.moleculeRadius;
-    float minX = reactor.reactorX + reactor.wallThickness + reactor.moleculeRadius;
-    float maxY = reactor.reactorY + reactor.reactorHeight - reactor.wallThickness - reactor.moleculeRadius;
-    float minY = reactor.reactorY + reactor.wallThickness + reactor.moleculeRadius;
+    Real maxX = reactor.reactorX + reactor.reactorWidth  - reactor.wallThickness - reactor.moleculeRadius;
+    Real minX = reactor.reactorX + reactor.wallThickness + reactor.moleculeRadius;
+    Real maxY = reactor.reactorY + reactor.reactorHeight - reactor.wallThickness - reactor.moleculeRadius;
+    Real minY = reactor.reactorY + reactor.wallThickness + reactor.moleculeRadius;
     
     Vector2f safeCollisionPos = collisionPos;
     safeCollisionPos.setX(std::clamp(collisionPos.getX(), minX + safeRadius, maxX - safeRadius));
     safeCollisionPos.setY(std::clamp(collisionPos.getY(), minY + safeRadius, maxY - safeRadius));
     
-    Vector2f commonVelocity = totalMomentum * (1.0f / static_cast<float>(numNewMolecules));
+    Vector2f commonVelocity = totalMomentum * (1.0f / static_cast<Real>(numNewMolecules));
     
-    std::vector<Vector2f> radialOffsets;
-    Vector2f totalRadial(0, 0, 0);
+    ScratchVector<Vector2f> radialOffsets{ArenaAllocator<Vector2f>(reactor.scratch)};
+    radialOffsets.reserve(fragments);
+    Vector2f totalRadial(0, 0);
     
-    for (int k = 0; k < numNewMolecules; ++k) {
-        float angle = 2 * 3.14159f * k / numNewMolecules;
-        float rx = std::cos(angle);
-        float ry = std::sin(angle);
-        radialOffsets.emplace_back(rx, ry, 0);
+    for (int k = 0; k < fragments; ++k) {
+        Real angle = 2 * 3.14159f * k / fragments;
+        Real rx = std::cos(angle);
+        Real ry = std::sin(angle);
+        radialOffsets.emplace_back(rx, ry);
         totalRadial = totalRadial + radialOffsets.back();
     }
     
-    Vector2f avgRadial = totalRadial * (1.0f / static_cast<float>(numNewMolecules));
+    Vector2f avgRadial = totalRadial * (1.0f / static_cast<Real>(fragments));
     for (auto& r : radialOffsets) {
         r = r - avgRadial;
     }
     
-    float spreadScale = reactor.moleculeSpeed * 0.3f;
+    Real spreadScale = reactor.moleculeSpeed * 0.3f;
     
-    for (int k = 0; k < numNewMolecules; ++k) {
-        float angle = 2 * 3.14159f * k / numNewMolecules;
-        float offsetX = std::cos(angle) * safeRadius;
-        float offsetY = std::sin(angle) * safeRadius;
+    for (int k = 0; k < fragments; ++k) {
+        Real angle = 2 * 3.14159f * k / fragments;
+        Real offsetX = std::cos(angle) * safeRadius;
+        Real offsetY = std::sin(angle) * safeRadius;
         
-        float posX = safeCollisionPos.getX() + offsetX;
-        float posY = safeCollisionPos.getY() + offsetY;
+        Real posX = safeCollisionPos.getX() + offsetX;
+        Real posY = safeCollisionPos.getY() + offsetY;
         
         posX = std::clamp(posX, minX, maxX);
         posY = std::clamp(posY, minY, maxY);
         
         Vector2f finalVel = commonVelocity + radialOffsets[k] * spreadScale;
         
-        reactor.addRoundMoleculeAt(posX, posY, finalVel.getX(), finalVel.getY());
+        reactor.addRoundMoleculeAt(posX, posY, finalVel.getX(), finalVel.getY(), fragmentMass);
     }
 }
 
-void Reactor::updateMoleculePositions(float dt) {
-    for (auto& mol : molecules) {
-        if (mol) {
-            mol->update(dt);
-            handleWallCollisions(*mol);
-        }
-    }
+void Reactor::updateMoleculePositions(Real dt) {
+    const size_t MOVE_GRAIN = 2048;
+
+    int hits = jobs.parallelReduce(molecules.size(), MOVE_GRAIN, 0,
+        [&](size_t begin, size_t end, int& partial) {
+            for (size_t i = begin; i < end; ++i) {
+                auto& mol = molecules[i];
+                if (!mol) continue;
+
+                if (collisionMode == CollisionMode::Swept) {
+                    partial += advanceSwept(*mol, dt);
+                } else {
+                    mol->update(dt);
+                    partial += handleWallCollisions(*mol);
+                }
+            }
+        },
+        [](int& total, int partial) { total += partial; });
+
+    rightWallHitsLastSecond += hits;
+    rightWallHitsTotal      += hits;
 }
 
-void Reactor::handleWallCollisions(Molecule& mol) {
+int Reactor::handleWallCollisions(Molecule& mol) {
+    int rightWallHits = 0;
     Vector2f pos = mol.getPosition();
     Vector2f size = mol.getSize();
 
@@ -337,7 +914,7 @@ void Reactor::handleWallCollisions(Molecule& mol) {
         Vector2f vel = mol.getVelocity();
         mol.setVelocity(-std::abs(vel.getX()), vel.getY());
         mol.setPosition(reactorX + reactorWidth - wallThickness - size.getX()/2, pos.getY());
-        rightWallHitsLastSecond++;
+        rightWallHits++;
     }
     if (pos.getY() - size.getY()/2 <= reactorY + wallThickness) {
         Vector2f vel = mol.getVelocity();
@@ -349,29 +926,132 @@ void Reactor::handleWallCollisions(Molecule& mol) {
         mol.setVelocity(vel.getX(), -std::abs(vel.getY()));
         mol.setPosition(pos.getX(), reactorY + reactorHeight - wallThickness - size.getY()/2);
     }
+    return rightWallHits;
 }
 
-void Reactor::updateStatistics() {
-    float totalEnergy = 0;
-    int roundCount = 0;
-    int squareCount = 0;
-    
-    for (const auto& mol : molecules) {
-        if (mol) {
-            Vector2f vel = mol->getVelocity();
-            float speedSq = vel.getX() * vel.getX() + vel.getY() * vel.getY();
-            totalEnergy += 0.5f * mol->getMass() * speedSq;
-            
-            if (mol->getType() == MoleculeType::Round) roundCount++;
-            else squareCount++;
+int Reactor::advanceSwept(Molecule& mol, Real dt) {
+    const int MAX_BOUNCES = 4;
+    const Real INF = std::numeric_limits<Real>::infinity();
+    int rightWallHits = 0;
+
+    Vector2f size = mol.getSize();
+    Real minX = reactorX + wallThickness + size.getX()/2;
+    Real maxX = reactorX + reactorWidth  - wallThickness - size.getX()/2;
+    Real minY = reactorY + wallThickness + size.getY()/2;
+    Real maxY = reactorY + reactorHeight - wallThickness - size.getY()/2;
+
+    mol.markStepStart();
+
+    Real remaining = dt;
+    for (int bounce = 0; bounce < MAX_BOUNCES && remaining > 0; ++bounce) {
+        Vector2f pos = mol.getPosition();
+        Vector2f vel = mol.getVelocity();
+
+        Real tx = INF, ty = INF;
+        if      (vel.getX() < 0) tx = (minX - pos.getX()) / vel.getX();
+        else if (vel.getX() > 0) tx = (maxX - pos.getX()) / vel.getX();
+        if      (vel.getY() < 0) ty = (minY - pos.getY()) / vel.getY();
+        else if (vel.getY() > 0) ty = (maxY - pos.getY()) / vel.getY();
+
+        Real t = std::max<Real>(std::min(tx, ty), 0);
+        if (t >= remaining) {
+            mol.update(remaining);
+            remaining = 0;
+            break;
+        }
+
+        mol.update(t);
+        remaining -= t;
+
+        if (tx <= ty) {
+            if (vel.getX() < 0) {
+                mol.setVelocity(std::abs(vel.getX()) * leftWallTemperature, vel.getY() * leftWallTemperature);
+            } else {
+                mol.setVelocity(-std::abs(vel.getX()), vel.getY());
+                rightWallHits++;
+            }
+        } else {
+            mol.setVelocity(vel.getX(), vel.getY() < 0 ? std::abs(vel.getY()) : -std::abs(vel.getY()));
         }
     }
+    // Out of bounces: move on for the rest of the step; the clamp below
+    // keeps it inside.
+    if (remaining > 0) {
+        mol.update(remaining);
+    }
+
+    Vector2f pos = mol.getPosition();
+    mol.setPosition(std::clamp(pos.getX(), minX, std::max(minX, maxX)),
+                    std::clamp(pos.getY(), minY, std::max(minY, maxY)));
+    return rightWallHits;
+}
+
+void Reactor::updateStatistics() {
+    const size_t STATS_GRAIN = 4096;
+
+    struct Totals {
+        Accum energy = 0;
+        int   round  = 0;
+        int   square = 0;
+        SpeedHistogram histogram;
+    };
+
+    speedHistogram.clear();
+    Totals identity;
+    identity.histogram = speedHistogram;
+
+    Totals totals = jobs.parallelReduce(molecules.size(), STATS_GRAIN, identity,
+        [&](size_t begin, size_t end, Totals& partial) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto& mol = molecules[i];
+                if (!mol) continue;
+
+                Vector2f vel = mol->getVelocity();
+                Real speedSq = vel.getX() * vel.getX() + vel.getY() * vel.getY();
+                Real energy = 0.5f * mol->getMass() * speedSq;
+                partial.energy += energy;
+
+                partial.histogram.add(static_cast<int>(mol->getType()), std::sqrt(speedSq), mol->getMass(), energy);
+
+                if (mol->getType() == MoleculeType::Round) partial.round++;
+                else partial.square++;
+            }
+        },
+        [](Totals& total, const Totals& partial) {
+            total.energy += partial.energy;
+            total.round  += partial.round;
+            total.square += partial.square;
+            total.histogram.merge(partial.histogram);
+        });
+
+    speedHistogram = std::move(totals.histogram);
+    Accum totalEnergy = totals.energy;
+    int roundCount    = totals.round;
+    int squareCount   = totals.square;
     
-    float temperature = molecules.empty() ? 0 : totalEnergy / std::max(1, (int)molecules.size());
+    Accum temperature = molecules.empty() ? 0 : totalEnergy / std::max(1, (int)molecules.size());
 
     moleculeHistory.      push_back(molecules.size());
     roundMoleculeHistory. push_back(roundCount);
     squareMoleculeHistory.push_back(squareCount);
     energyHistory.        push_back(totalEnergy);
     temperatureHistory.   push_back(temperature);
+
+    if (historyLimit > 0) {
+        setHistoryLimit(historyLimit);
+    }
+}
+
+void Reactor::setHistoryLimit(size_t limit) {
+    historyLimit = limit;
+    if (limit == 0) return;
+
+    auto trim = [limit](auto& history) {
+        while (history.size() > limit) history.pop_front();
+    };
+    trim(moleculeHistory);
+    trim(roundMoleculeHistory);
+    trim(squareMoleculeHistory);
+    trim(energyHistory);
+    trim(temperatureHistory);
 }
\ No newline at end of file
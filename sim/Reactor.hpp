@@ -9,7 +9,19 @@
 #include <functional>  
 #include <cmath>       
 #include <algorithm>    
-#include "../../start/vector.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "Vec2.hpp"
+#include "SpatialGrid.hpp"
+#include "ReactorCommands.hpp"
+#include "SpeedHistogram.hpp"
+#include "ReactionStats.hpp"
+#include "JobSystem.hpp"
+#include "ScratchArena.hpp"
+
+class SharedStateExporter;
+struct StatsSample;
 
 
 enum class MoleculeType {
@@ -17,82 +29,170 @@ enum class MoleculeType {
     Square
 };
 
-using Vector2f = Vector<float>;
+// Discrete tests overlap after the move; Swept also catches contacts that
+// happen part-way through the step, so larger dt does not tunnel.
+enum class CollisionMode {
+    Discrete,
+    Swept
+};
+
+// What a reaction does when its products would push the population past
+// the cap: Reject bounces the pair apart instead, Merge spawns fewer,
+// heavier fragments that fit, Defer queues it for the next step.
+enum class PopulationPolicy {
+    Reject,
+    Merge,
+    Defer
+};
+
+using Vector2f = Vec2;
+
+// Two molecules by id, e.g. a reaction held back for a later step.
+using MoleculePair = std::pair<std::uint32_t, std::uint32_t>;
 
 class Molecule {
 protected:
     Vector2f position;
     Vector2f velocity;
-    float mass;
+    Vector2f stepStart;   // position before the current step's move
+    Real mass;
     MoleculeType type;
+    std::uint32_t id = 0;
 
 public:
-    Molecule(MoleculeType t, float x, float y, float vx, float vy, float mass);
+    Molecule(MoleculeType t, Real x, Real y, Real vx, Real vy, Real mass);
     virtual ~Molecule() = default;
 
     MoleculeType getType() const { return type; }
     Vector2f getPosition() const { return position; }
     Vector2f getVelocity() const { return velocity; }
-    float getMass() const { return mass; }
+    // Where the molecule was when the last swept move began.
+    Vector2f getStepStart() const { return stepStart; }
+    void markStepStart() { stepStart = position; }
+    Real getMass() const { return mass; }
+    // Stable handle assigned by the Reactor; 0 until the molecule is added.
+    std::uint32_t getId() const { return id; }
+    void setId(std::uint32_t value) { id = value; }
 
-    void setVelocity(float vx, float vy);
-    void setPosition(float x, float y);
+    void setVelocity(Real vx, Real vy);
+    void setPosition(Real x, Real y);
     
     virtual Vector2f getSize() const = 0;
-    virtual void update(float dt) = 0;
+    virtual void update(Real dt) = 0;
     virtual bool collidesWith(const Molecule& other) const = 0;
 };
 
 class RoundMolecule : public Molecule {
 private:
-    float radius;
+    Real radius;
 
 public:
-    RoundMolecule(float x, float y, float vx, float vy, float radius, float mass = 1.0f);
+    RoundMolecule(Real x, Real y, Real vx, Real vy, Real radius, Real mass = 1);
     Vector2f getSize() const override;
-    void update(float dt) override;
+    void update(Real dt) override;
     bool collidesWith(const Molecule& other) const override;
-    float getRadius() const { return radius; }
+    Real getRadius() const { return radius; }
 };
 
 class SquareMolecule : public Molecule {
 private:
-    float size;
+    Real size;
 
 public:
-    SquareMolecule(float x, float y, float vx, float vy, float size, float mass = 2.0f);
+    SquareMolecule(Real x, Real y, Real vx, Real vy, Real size, Real mass = 2);
     Vector2f getSize() const override;
-    void update(float dt) override;
+    void update(Real dt) override;
     bool collidesWith(const Molecule& other) const override;
-    float getSizeValue() const { return size; }
+    Real getSizeValue() const { return size; }
+};
+
+// Plain copy of one molecule; `size` is the radius or the edge length.
+struct MoleculeState {
+    std::uint32_t id;
+    MoleculeType  type;
+    Real          x, y, vx, vy;
+    Real          mass;
+    Real          size;
+};
+
+// The per-step state update() carries over besides the molecules and rng.
+struct ReactorScalars {
+    long long     stepCount               = 0;
+    double        simTime                 = 0;
+    long long     rightWallHitsTotal      = 0;
+    long long     lastReorder             = 0;
+    int           rightWallHitsLastSecond = 0;
+    Real          hitTimer                = 0;
+    Real          leftWallTemperature     = 1;
+    Real          lastDt                  = 0;
+    Real          reactorWidth            = 0;
+    std::uint32_t nextMoleculeId          = 1;
 };
 
 class Reactor {
 private:
     std::vector<std::unique_ptr<Molecule>> molecules;
     std::vector<size_t> moleculesToRemove;
+    std::vector<char>   removalMarks;   // by index, set for the entries of moleculesToRemove
     
     std::mt19937 rng;
-    std::uniform_real_distribution<float> distVel;
+    std::uniform_real_distribution<Real> distVel;
 
     int rightWallHitsLastSecond = 0;
-    float hitTimer = 0.f;
-    float leftWallTemperature = 1.0f;
+    long long rightWallHitsTotal = 0;
+    Real hitTimer = 0;
+    Real leftWallTemperature = 1;
+    Real lastDt = 0;
+    long long stepCount = 0;
+    std::uint32_t nextMoleculeId = 1;
+    double simTime = 0;
+    CollisionMode collisionMode = CollisionMode::Discrete;
+    bool reactionsEnabled = true;
+
+    int    reactionBudget = 0;
+    size_t populationCap  = 0;
+    size_t productLimit   = static_cast<size_t>(-1);
+    PopulationPolicy populationPolicy = PopulationPolicy::Reject;
+    std::vector<MoleculePair> deferredPairs;   // oldest first
+
+    int   reorderInterval  = 0;
+    float reorderLocality  = 0;
+    long long lastReorder  = 0;
 
     std::deque<int>   moleculeHistory;
     std::deque<int>   roundMoleculeHistory;
     std::deque<int>   squareMoleculeHistory;
-    std::deque<float> energyHistory;
-    std::deque<float> temperatureHistory;
+    std::deque<Accum> energyHistory;
+    std::deque<Accum> temperatureHistory;
+    size_t            historyLimit = 0;
+    SpeedHistogram    speedHistogram;
+    ReactionStats     reactionStats;
+
+    ReactorCommandQueue commandQueue;
+
+    std::vector<std::function<void(const Reactor&)>> stepObservers;
+    std::unique_ptr<SharedStateExporter> sharedExport;
+
+    JobSystem jobs;
+    std::vector<size_t> collisionPartner;
+    ScratchArena scratch;   // emptied at the end of every update()
 
-    float reactorX, reactorY, reactorWidth, reactorHeight;
-    float wallThickness;
-    float moleculeRadius;
-    float squareSize;
-    float moleculeSpeed;
+    mutable SpatialGrid spatialGrid;
+    mutable bool spatialGridDirty = true;
+    mutable std::vector<std::uint32_t> indexOfId;
+    mutable bool idIndexDirty = true;
 
+    Real reactorX, reactorY, reactorWidth, reactorHeight;
+    Real wallThickness;
+    Real moleculeRadius;
+    Real squareSize;
+    Real moleculeSpeed;
+
+    void addMolecule(std::unique_ptr<Molecule> mol);
     void markForRemoval(size_t index);
+    bool isMarkedForRemoval(size_t index) const;
     void processRemovals();
+    void maybeReorder();
     static void handleRoundRoundCollision(Reactor& reactor, size_t i, size_t j, const Vector2f& collisionPos);
     static void handleRoundSquareCollision(Reactor& reactor, size_t i, size_t j, const Vector2f& collisionPos);
     static void handleSquareSquareCollision(Reactor& reactor, size_t i, size_t j, const Vector2f& collisionPos);
@@ -100,29 +200,106 @@ private:
     using ReactionHandler = void(*)(Reactor&, size_t, size_t, const Vector2f&);
     ReactionHandler reactionTable[2][2];
 
-    void updateMoleculePositions(float dt);
-    void handleWallCollisions(Molecule& mol);
+    void updateMoleculePositions(Real dt);
+    int  handleWallCollisions(Molecule& mol);
+    int  advanceSwept(Molecule& mol, Real dt);
+    bool collides(const Molecule& a, const Molecule& b) const;
+    bool atPopulationCap() const { return populationCap > 0 && molecules.size() >= populationCap; }
+    size_t squareSquareProducts(size_t i, size_t j) const;
+    void bounceApart(size_t i, size_t j);
     void updateStatistics();
 
 public:
-    Reactor(float x, float y, float width, float height, float wallThick, 
-            float molRadius, float sqSize, float molSpeed);
+    Reactor(Real x, Real y, Real width, Real height, Real wallThick, 
+            Real molRadius, Real sqSize, Real molSpeed);
+    ~Reactor();
 
+    void seed(unsigned int value);
+    // Threads used by the update phases; 1 (the default) runs them serially.
+    void setWorkerCount(size_t workers) { jobs.setWorkerCount(workers); }
+    size_t getWorkerCount() const { return jobs.getWorkerCount(); }
+    JobSystem& getJobSystem() { return jobs; }
+    const ScratchArena& getScratchArena() const { return scratch; }
     void increaseLeftWallTemperature();
     void decreaseLeftWallTemperature();
+    void setLeftWallTemperature(Real temperature);
+    void setCollisionMode(CollisionMode mode) { collisionMode = mode; }
+    CollisionMode getCollisionMode() const { return collisionMode; }
+    // With reactions off every colliding pair bounces apart elastically, so
+    // at wall temperature 1 the box conserves energy.
+    void setReactionsEnabled(bool enabled) { reactionsEnabled = enabled; }
+    bool getReactionsEnabled() const { return reactionsEnabled; }
+    // At most `perStep` reactions run per step (0: unlimited). The rest are
+    // deferred: queued by id and served first next step, oldest first, for
+    // as long as both molecules are still there.
+    void setReactionBudget(int perStep) { reactionBudget = std::max(0, perStep); }
+    int getReactionBudget() const { return reactionBudget; }
+    // Hard limit on the molecule count (0: none). Additions are clipped to
+    // it; reactions that would grow past it follow `policy`.
+    void setPopulationCap(size_t cap, PopulationPolicy policy) { populationCap = cap; populationPolicy = policy; }
+    size_t getPopulationCap() const { return populationCap; }
+    PopulationPolicy getPopulationPolicy() const { return populationPolicy; }
+    // Sorts molecules along a Z-order curve every `interval` steps (0: never)
+    // or, with `minLocality` > 0, sooner once measureLocality() drops below
+    // it. Indices change; ids do not. Collision pairs are served in index
+    // order, so a reordered run diverges from an unreordered one.
+    void setReorderPolicy(int interval, float minLocality = 0);
+    int getReorderInterval() const { return reorderInterval; }
+    float getReorderLocality() const { return reorderLocality; }
+    void reorderMolecules();
+    // Fraction of consecutive molecules that are also neighbours in space.
+    float measureLocality() const;
     void addRoundMolecule();
     void addSquareMolecule();
+    void addRoundMolecules(int count);
+    void addSquareMolecules(int count);
+    void removeLastMolecules(int count);
     void handleCollisions();
     void removeLastMolecule();
-    void addSquareMoleculeAt(float x, float y, float mass = 2.0f);
-    void addRoundMoleculeAt(float x, float y, float vx, float vy);
-    void resize(float newWidth);
-    void update(float dt);
+    void addSquareMoleculeAt(Real x, Real y, Real mass = 2);
+    void addRoundMoleculeAt(Real x, Real y, Real vx, Real vy, Real mass = 1);
+    void resize(Real newWidth);
+    void update(Real dt);
+
+    // Queued mutations are applied at the start of the next update(), or
+    // explicitly with applyCommands() when the sim is not stepping.
+    ReactorCommandQueue& getCommandQueue() { return commandQueue; }
+    size_t applyCommands() { return commandQueue.apply(*this); }
     void handleReaction(size_t i, size_t j);
 
+    // Called at the end of every update(), after the statistics are in.
+    void addStepObserver(std::function<void(const Reactor&)> observer) { stepObservers.push_back(std::move(observer)); }
+    long long getStepCount() const { return stepCount; }
+    double getSimTime() const { return simTime; }
+    Real getLastDt() const { return lastDt; }
+
+    // Plain-data copies of the complete state, used by ReactorHistory to
+    // rewind. Loading replaces the molecules and keeps their ids.
+    void saveMolecules(std::vector<MoleculeState>& out) const;
+    void loadMolecules(const std::vector<MoleculeState>& states);
+    ReactorScalars getScalars() const;
+    void setScalars(const ReactorScalars& scalars);
+    const std::vector<MoleculePair>& getDeferredPairs() const { return deferredPairs; }
+    void setDeferredPairs(const std::vector<MoleculePair>& pairs) { deferredPairs = pairs; }
+    const std::mt19937& getRng() const { return rng; }
+    void setRng(const std::mt19937& state) { rng = state; }
+    // Edits the newest end of the in-memory histories when rewinding.
+    void dropHistorySamples(size_t count);
+    void appendHistorySample(const StatsSample& sample);
+    // Publishes every step into the POSIX shared-memory ring `name` (e.g.
+    // "/reactor") for SharedStateReader consumers; see SharedState.hpp.
+    bool enableSharedExport(const std::string& name, size_t capacity, size_t slots = 8);
+    void disableSharedExport();
+    bool isSharedExportEnabled() const { return sharedExport != nullptr; }
+
     void clearAll() {
         molecules.clear();
+        spatialGridDirty = true;
+        idIndexDirty = true;
+        reactionStats.reset();
         moleculesToRemove.clear();
+        removalMarks.clear();
+        deferredPairs.clear();
         if (!moleculeHistory.empty()) {
             int last_count = moleculeHistory.back();
             moleculeHistory.clear();
@@ -143,20 +320,43 @@ public:
     }
 
     const std::vector<std::unique_ptr<Molecule>>& getMolecules() const { return molecules; }
+    // Rebuilt on demand, at most once per change to the molecule set.
+    const SpatialGrid& getSpatialGrid() const;
+
+    // Spatial queries on molecule centres, answered from the spatial grid.
+    // Results are indices into getMolecules(), valid until the next update.
+    static constexpr size_t NO_MOLECULE = static_cast<size_t>(-1);
+    size_t findNearest  (Real x, Real y, Real maxDistance = std::numeric_limits<Real>::infinity()) const;
+    // Up to k molecules, nearest first.
+    void   findNearestK (Real x, Real y, size_t k, std::vector<size_t>& out) const;
+    void   findInRect   (Real left, Real top, Real right, Real bottom, std::vector<size_t>& out) const;
+    void   findInCircle (Real x, Real y, Real radius, std::vector<size_t>& out) const;
+    size_t countInCircle(Real x, Real y, Real radius) const;
+    // Uses an id table rebuilt on demand after the molecule order changed.
+    size_t findById     (std::uint32_t id) const;
     int getRightWallHits() const { return rightWallHitsLastSecond; }
-    float getLeftWallTemperature() const { return leftWallTemperature; }
+    long long getTotalRightWallHits() const { return rightWallHitsTotal; }
+    Real getLeftWallTemperature() const { return leftWallTemperature; }
     
     const std::deque<int>& getMoleculeHistory() const { return moleculeHistory; }
     const std::deque<int>& getRoundMoleculeHistory() const { return roundMoleculeHistory; }
     const std::deque<int>& getSquareMoleculeHistory() const { return squareMoleculeHistory; }
-    const std::deque<float>& getEnergyHistory() const { return energyHistory; }
-    const std::deque<float>& getTemperatureHistory() const { return temperatureHistory; }
+    const std::deque<Accum>& getEnergyHistory() const { return energyHistory; }
+    const std::deque<Accum>& getTemperatureHistory() const { return temperatureHistory; }
+    const SpeedHistogram&    getSpeedHistogram    () const { return speedHistogram; }
+    void setSpeedHistogramBins(int bins, float maxSpeed) { speedHistogram.configure(bins, maxSpeed); }
+    // Caps the in-memory histories at `limit` samples (0 keeps everything);
+    // long runs keep the full series in a StatsArchive instead.
+    void setHistoryLimit(size_t limit);
+    size_t getHistoryLimit() const { return historyLimit; }
+    const ReactionStats&     getReactionStats     () const { return reactionStats; }
+    ReactionStats&           getReactionStats     ()       { return reactionStats; }
     
-    float getReactorX() const { return reactorX; }
-    float getReactorY() const { return reactorY; }
-    float getReactorWidth() const { return reactorWidth; }
-    float getReactorHeight() const { return reactorHeight; }
-    float getWallThickness() const { return wallThickness; }
+    Real getReactorX() const { return reactorX; }
+    Real getReactorY() const { return reactorY; }
+    Real getReactorWidth() const { return reactorWidth; }
+    Real getReactorHeight() const { return reactorHeight; }
+    Real getWallThickness() const { return wallThickness; }
 };
 
 #endif
\ No newline at end of file
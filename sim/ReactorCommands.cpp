@@ -0,0 +1,159 @@
+// ReactorCommands.cpp
+#include "ReactorCommands.hpp"
+#include "Reactor.hpp"
+#include "ReactorHistory.hpp"
+#include <algorithm>
+
+namespace {
+
+bool touchesMolecules(ReactorCommandType type) {
+    return type == ReactorCommandType::AddRound  ||
+           type == ReactorCommandType::AddSquare ||
+           type == ReactorCommandType::RemoveLast;
+}
+
+}
+
+void ReactorCommandQueue::setCollisionMode(CollisionMode mode) {
+    push({ReactorCommandType::SetCollisionMode, static_cast<int>(mode)});
+}
+
+void ReactorCommandQueue::setPopulationCap(size_t cap, PopulationPolicy policy) {
+    ReactorCommand command{ReactorCommandType::SetPopulationCap, static_cast<int>(policy)};
+    command.limit = cap;
+    push(command);
+}
+
+void ReactorCommandQueue::restore(ReactorHistory& history, long long step) {
+    ReactorCommand command{ReactorCommandType::Restore};
+    command.history = &history;
+    command.step    = step;
+    push(command);
+}
+
+void ReactorCommandQueue::push(const ReactorCommand& command) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (command.type == ReactorCommandType::ClearAll) {
+        // Anything queued that only adds or removes molecules is moot.
+        pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+            [](const ReactorCommand& c) {
+                return touchesMolecules(c.type) || c.type == ReactorCommandType::ClearAll;
+            }), pending_.end());
+        pending_.push_back(command);
+        return;
+    }
+
+    if (!pending_.empty() && pending_.back().type == command.type) {
+        ReactorCommand& last = pending_.back();
+        switch (command.type) {
+            case ReactorCommandType::AddRound:
+            case ReactorCommandType::AddSquare:
+            case ReactorCommandType::RemoveLast:
+                last.count += command.count;
+                return;
+
+            // Clamped adjustments only add up while they push the same way:
+            // Up then Down at the cap has to end one step below it.
+            case ReactorCommandType::AdjustTemperature:
+                if ((last.count < 0) == (command.count < 0)) {
+                    last.count += command.count;
+                    return;
+                }
+                break;
+
+            case ReactorCommandType::ResizeBy:
+                if ((last.value < 0) == (command.value < 0) &&
+                    last.minValue == command.minValue && last.maxValue == command.maxValue) {
+                    last.value += command.value;
+                    return;
+                }
+                break;
+
+            // Only the last value set counts.
+            case ReactorCommandType::SetCollisionMode:
+            case ReactorCommandType::SetReactionBudget:
+            case ReactorCommandType::SetPopulationCap:
+            case ReactorCommandType::Restore:
+                last = command;
+                return;
+
+            default:
+                break;
+        }
+    }
+
+    pending_.push_back(command);
+}
+
+size_t ReactorCommandQueue::apply(Reactor& reactor) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) return 0;
+        applying_.swap(pending_);
+    }
+
+    for (const auto& command : applying_) {
+        switch (command.type) {
+            case ReactorCommandType::AddRound:
+                reactor.addRoundMolecules(command.count);
+                break;
+
+            case ReactorCommandType::AddSquare:
+                reactor.addSquareMolecules(command.count);
+                break;
+
+            case ReactorCommandType::RemoveLast:
+                reactor.removeLastMolecules(command.count);
+                break;
+
+            case ReactorCommandType::ClearAll:
+                reactor.clearAll();
+                break;
+
+            case ReactorCommandType::ResizeBy: {
+                // Limits only stop further movement in that direction.
+                float width  = reactor.getReactorWidth();
+                float target = width + command.value;
+                if (command.value < 0) target = std::max(target, std::min(width, command.minValue));
+                else                   target = std::min(target, std::max(width, command.maxValue));
+                reactor.resize(target);
+                break;
+            }
+
+            case ReactorCommandType::AdjustTemperature:
+                reactor.setLeftWallTemperature(reactor.getLeftWallTemperature() + 0.2f * command.count);
+                break;
+
+            case ReactorCommandType::SetCollisionMode:
+                reactor.setCollisionMode(static_cast<CollisionMode>(command.count));
+                break;
+
+            case ReactorCommandType::SetReactionBudget:
+                reactor.setReactionBudget(command.count);
+                break;
+
+            case ReactorCommandType::SetPopulationCap:
+                reactor.setPopulationCap(command.limit, static_cast<PopulationPolicy>(command.count));
+                break;
+
+            case ReactorCommandType::Restore:
+                command.history->restore(reactor, command.step);
+                break;
+        }
+    }
+
+    size_t applied = applying_.size();
+    applying_.clear();
+    return applied;
+}
+
+bool ReactorCommandQueue::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.empty();
+}
+
+size_t ReactorCommandQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
@@ -0,0 +1,80 @@
+// ReactorCommands.hpp
+#ifndef REACTOR_COMMANDS_HPP
+#define REACTOR_COMMANDS_HPP
+
+#include <mutex>
+#include <vector>
+
+class Reactor;
+class ReactorHistory;
+enum class CollisionMode;
+enum class PopulationPolicy;
+
+enum class ReactorCommandType {
+    AddRound,
+    AddSquare,
+    RemoveLast,
+    ClearAll,
+    ResizeBy,
+    AdjustTemperature,
+    SetCollisionMode,
+    SetReactionBudget,
+    SetPopulationCap,
+    Restore
+};
+
+struct ReactorCommand {
+    ReactorCommandType type;
+    int   count = 1;
+    float value = 0;
+
+    // Width limits for ResizeBy.
+    float minValue = 0;
+    float maxValue = 0;
+
+    // The cap for SetPopulationCap, with the policy in `count`; the mode
+    // and the budget of the other settings go in `count` as well.
+    size_t limit = 0;
+
+    // The recorded step Restore puts the reactor back to.
+    ReactorHistory* history = nullptr;
+    long long       step    = 0;
+};
+
+// Mutations recorded from UI callbacks or scripts and applied together at
+// the next step boundary. push() folds a command into the previous one when
+// they are of the same kind, so 500 clicks on "Add Round" become a single
+// bulk insert; clamped adjustments only fold while they go the same way,
+// and a setting or restore replaces the one queued just before it.
+// Safe to push from another thread than the one stepping.
+class ReactorCommandQueue {
+private:
+    mutable std::mutex mutex_;
+    std::vector<ReactorCommand> pending_;
+    std::vector<ReactorCommand> applying_;
+
+public:
+    void push(const ReactorCommand& command);
+
+    void addRound         (int count = 1)   { push({ReactorCommandType::AddRound,   count}); }
+    void addSquare        (int count = 1)   { push({ReactorCommandType::AddSquare,  count}); }
+    void removeLast       (int count = 1)   { push({ReactorCommandType::RemoveLast, count}); }
+    void clearAll         ()                { push({ReactorCommandType::ClearAll}); }
+    void adjustTemperature(int steps)       { push({ReactorCommandType::AdjustTemperature, steps}); }
+    void resizeBy         (float delta, float minWidth, float maxWidth) {
+        push({ReactorCommandType::ResizeBy, 1, delta, minWidth, maxWidth});
+    }
+    void setCollisionMode (CollisionMode mode);
+    void setReactionBudget(int perStep)     { push({ReactorCommandType::SetReactionBudget, perStep}); }
+    void setPopulationCap (size_t cap, PopulationPolicy policy);
+    // Restores `step` from `history`, which has to outlive the queued command.
+    void restore          (ReactorHistory& history, long long step);
+
+    // Returns the number of (merged) commands applied.
+    size_t apply(Reactor& reactor);
+
+    bool   empty() const;
+    size_t size () const;
+};
+
+#endif // REACTOR_COMMANDS_HPP
@@ -0,0 +1,258 @@
+// ReactorHistory.cpp
+#include "ReactorHistory.hpp"
+#include <cstring>
+
+namespace {
+
+// Recording and replay must agree bit for bit, so both go through here.
+void predict(MoleculeState& state, Real dt) {
+    state.x = state.x + state.vx * dt;
+    state.y = state.y + state.vy * dt;
+}
+
+bool sameBits(Real a, Real b) {
+    return std::memcmp(&a, &b, sizeof(Real)) == 0;
+}
+
+bool sameState(const MoleculeState& a, const MoleculeState& b) {
+    return a.id == b.id && a.type == b.type &&
+           sameBits(a.x,  b.x)  && sameBits(a.y,  b.y) &&
+           sameBits(a.vx, b.vx) && sameBits(a.vy, b.vy) &&
+           sameBits(a.mass, b.mass) && sameBits(a.size, b.size);
+}
+
+}
+
+ReactorHistory::ReactorHistory(size_t keyframeInterval, size_t memoryBudget)
+    : keyframe_interval_(std::max<size_t>(1, keyframeInterval)),
+      memory_budget_(memoryBudget) {
+}
+
+long long ReactorHistory::getFirstStep() const {
+    return segments_.empty() ? 0 : segments_.front().scalars.stepCount;
+}
+
+long long ReactorHistory::getLastStep() const {
+    if (segments_.empty()) return 0;
+    const Segment& last = segments_.back();
+    return last.scalars.stepCount + static_cast<long long>(last.deltas.size());
+}
+
+void ReactorHistory::clear() {
+    segments_.clear();
+    current_.clear();
+    bytes_ = 0;
+}
+
+void ReactorHistory::record(const Reactor& reactor) {
+    long long step = reactor.getStepCount();
+    if (!segments_.empty() && step <= getLastStep()) {
+        truncateAfter(step - 1);
+    }
+
+    // A delta needs the state of the step right before this one.
+    bool contiguous = !segments_.empty() && current_scalars_.stepCount == step - 1 && getLastStep() == step - 1;
+    if (!contiguous) {
+        clear();
+    }
+
+    if (segments_.empty() || segments_.back().deltas.size() + 1 >= keyframe_interval_ || !addDelta(reactor)) {
+        addKeyframe(reactor);
+    }
+    enforceBudget();
+}
+
+void ReactorHistory::addKeyframe(const Reactor& reactor) {
+    segments_.emplace_back();
+    Segment& segment = segments_.back();
+    reactor.saveMolecules(segment.keyframe);
+    segment.scalars  = reactor.getScalars();
+    segment.sample   = StatsSample::fromReactor(reactor);
+    segment.rng      = reactor.getRng();
+    segment.deferred = reactor.getDeferredPairs();
+    segment.stats    = reactor.getReactionStats();
+    segment.bytes    = sizeof(Segment) + segment.keyframe.capacity() * sizeof(MoleculeState) +
+                       segment.deferred.capacity() * sizeof(MoleculePair) +
+                       segment.stats.getRecentHeatMap().capacity() * sizeof(float) +
+                       segment.stats.getTotalHeatMap().capacity() * sizeof(long long);
+    bytes_ += segment.bytes;
+
+    current_         = segment.keyframe;
+    current_rng_     = segment.rng;
+    current_scalars_ = segment.scalars;
+}
+
+bool ReactorHistory::addDelta(const Reactor& reactor) {
+    StepRecord record;
+    record.scalars  = reactor.getScalars();
+    record.sample   = StatsSample::fromReactor(reactor);
+    record.deferred = reactor.getDeferredPairs();
+    record.reactions     = reactor.getReactionStats().getLastStep();
+    record.reactionCells = reactor.getReactionStats().getLastStepCells();
+    reactor.saveMolecules(scratch_);
+
+    // Survivors keep their relative order and new molecules are appended
+    // with fresh ids, so one merge walk pairs the two steps up. Anything
+    // else (a reorder, say) fails the walk and gets a keyframe instead.
+    Real dt = record.scalars.lastDt;
+    size_t j = 0;
+    for (size_t i = 0; i < current_.size(); ++i) {
+        if (j < scratch_.size() && scratch_[j].id == current_[i].id) {
+            MoleculeState predicted = current_[i];
+            predict(predicted, dt);
+            if (!sameState(predicted, scratch_[j])) {
+                record.changed.emplace_back(static_cast<std::uint32_t>(j), scratch_[j]);
+            }
+            ++j;
+        } else {
+            record.removed.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    for (; j < scratch_.size(); ++j) {
+        if (scratch_[j].id < current_scalars_.nextMoleculeId) return false;
+        record.added.push_back(scratch_[j]);
+    }
+
+    if (reactor.getRng() != current_rng_) {
+        record.rng = std::make_unique<std::mt19937>(reactor.getRng());
+        current_rng_ = reactor.getRng();
+    }
+
+    current_.swap(scratch_);
+    current_scalars_ = record.scalars;
+
+    Segment& segment = segments_.back();
+    size_t bytes = recordBytes(record);
+    segment.deltas.push_back(std::move(record));
+    segment.bytes += bytes;
+    bytes_ += bytes;
+    return true;
+}
+
+size_t ReactorHistory::recordBytes(const StepRecord& record) {
+    return sizeof(StepRecord) +
+           record.removed.capacity() * sizeof(std::uint32_t) +
+           record.changed.capacity() * sizeof(std::pair<std::uint32_t, MoleculeState>) +
+           record.added.capacity()   * sizeof(MoleculeState) +
+           record.deferred.capacity() * sizeof(MoleculePair) +
+           record.reactionCells.capacity() * sizeof(std::uint32_t) +
+           (record.rng ? sizeof(std::mt19937) : 0);
+}
+
+void ReactorHistory::applyDelta(const StepRecord& delta, std::vector<MoleculeState>& state) {
+    if (!delta.removed.empty()) {
+        size_t kept = 0, r = 0;
+        for (size_t i = 0; i < state.size(); ++i) {
+            if (r < delta.removed.size() && delta.removed[r] == i) {
+                ++r;
+                continue;
+            }
+            state[kept++] = state[i];
+        }
+        state.resize(kept);
+    }
+
+    for (MoleculeState& molecule : state) {
+        predict(molecule, delta.scalars.lastDt);
+    }
+    for (const auto& change : delta.changed) {
+        state[change.first] = change.second;
+    }
+    state.insert(state.end(), delta.added.begin(), delta.added.end());
+}
+
+void ReactorHistory::truncateAfter(long long step) {
+    while (!segments_.empty() && segments_.back().scalars.stepCount > step) {
+        bytes_ -= segments_.back().bytes;
+        segments_.pop_back();
+    }
+    if (segments_.empty()) return;
+
+    Segment& segment = segments_.back();
+    size_t keep = static_cast<size_t>(step - segment.scalars.stepCount);
+    while (segment.deltas.size() > keep) {
+        size_t bytes = recordBytes(segment.deltas.back());
+        segment.bytes -= bytes;
+        bytes_ -= bytes;
+        segment.deltas.pop_back();
+    }
+}
+
+void ReactorHistory::enforceBudget() {
+    while (bytes_ > memory_budget_ && segments_.size() > 1) {
+        bytes_ -= segments_.front().bytes;
+        segments_.pop_front();
+    }
+}
+
+bool ReactorHistory::restore(Reactor& reactor, long long step) {
+    if (segments_.empty() || step < getFirstStep() || step > getLastStep()) return false;
+
+    auto segment = segments_.end();
+    do {
+        --segment;
+    } while (segment->scalars.stepCount > step);
+
+    current_         = segment->keyframe;
+    current_rng_     = segment->rng;
+    current_scalars_ = segment->scalars;
+    ReactionStats stats = segment->stats;
+
+    size_t count = static_cast<size_t>(step - segment->scalars.stepCount);
+    for (size_t k = 0; k < count; ++k) {
+        const StepRecord& delta = segment->deltas[k];
+        applyDelta(delta, current_);
+        if (delta.rng) current_rng_ = *delta.rng;
+        current_scalars_ = delta.scalars;
+        stats.replayStep(delta.reactions, delta.reactionCells, delta.scalars.lastDt);
+    }
+    const std::vector<MoleculePair>& deferred = count == 0 ? segment->deferred : segment->deltas[count - 1].deferred;
+
+    // Bring the graph histories to the same step: drop the samples past it,
+    // or replay recorded ones when scrubbing forwards.
+    long long now = reactor.getStepCount();
+    if (step < now) {
+        reactor.dropHistorySamples(static_cast<size_t>(now - step));
+    }
+    for (long long s = std::max(now + 1, getFirstStep()); s <= step; ++s) {
+        auto owner = segments_.end();
+        do {
+            --owner;
+        } while (owner->scalars.stepCount > s);
+        size_t index = static_cast<size_t>(s - owner->scalars.stepCount);
+        reactor.appendHistorySample(index == 0 ? owner->sample : owner->deltas[index - 1].sample);
+    }
+
+    reactor.loadMolecules(current_);
+    reactor.setScalars(current_scalars_);
+    reactor.setRng(current_rng_);
+    reactor.setDeferredPairs(deferred);
+    reactor.getReactionStats() = std::move(stats);
+    return true;
+}
+
+long long ReactorHistory::stepAtTime(double time) const {
+    if (segments_.empty()) return 0;
+
+    long long best = getFirstStep();
+    for (const Segment& segment : segments_) {
+        if (segment.scalars.simTime > time) break;
+        best = segment.scalars.stepCount;
+        for (const StepRecord& delta : segment.deltas) {
+            if (delta.scalars.simTime > time) return best;
+            best = delta.scalars.stepCount;
+        }
+    }
+    return best;
+}
+
+double ReactorHistory::timeOfStep(long long step) const {
+    for (auto segment = segments_.rbegin(); segment != segments_.rend(); ++segment) {
+        if (segment->scalars.stepCount > step) continue;
+        size_t index = static_cast<size_t>(step - segment->scalars.stepCount);
+        if (index == 0)                     return segment->scalars.simTime;
+        if (index <= segment->deltas.size()) return segment->deltas[index - 1].scalars.simTime;
+        break;
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// ReactorHistory.hpp
+#ifndef REACTOR_HISTORY_HPP
+#define REACTOR_HISTORY_HPP
+
+#include "Reactor.hpp"
+#include "StatsArchive.hpp"
+#include <deque>
+#include <memory>
+#include <vector>
+
+// In-memory rewind buffer for a Reactor. Every `keyframeInterval` steps it
+// stores a full copy of the state; the steps in between are deltas
+// against a prediction in which every molecule just moved along its
+// velocity. Only molecules that bounced, reacted or were added or removed
+// are stored, so a quiet step costs a few dozen bytes.
+//
+// Attach record() as a step observer. restore() rebuilds any recorded
+// step from the keyframe before it, reaction counters included: each
+// segment keeps a copy of the ReactionStats and each delta the step's
+// counts and heat map cells to replay. Stepping the reactor after a restore
+// drops the recorded future. The oldest keyframe and its deltas are
+// dropped once the memory budget is exceeded.
+class ReactorHistory {
+private:
+    struct StepRecord {
+        ReactorScalars scalars;
+        StatsSample    sample;
+        std::vector<std::uint32_t>                           removed;  // indices in the previous step
+        std::vector<std::pair<std::uint32_t, MoleculeState>> changed;  // indices after the removals
+        std::vector<MoleculeState>                           added;
+        std::unique_ptr<std::mt19937>                        rng;      // only when it advanced
+        std::vector<MoleculePair>                            deferred;
+        ReactionStats::Counts                                reactions;
+        std::vector<std::uint32_t>                           reactionCells;
+    };
+
+    struct Segment {
+        std::vector<MoleculeState> keyframe;
+        ReactorScalars             scalars;
+        StatsSample                sample;
+        std::mt19937               rng;
+        std::vector<MoleculePair>  deferred;
+        ReactionStats              stats;
+        std::vector<StepRecord>    deltas;
+        size_t                     bytes = 0;
+    };
+
+    size_t keyframe_interval_;
+    size_t memory_budget_;
+    size_t bytes_ = 0;
+
+    std::deque<Segment> segments_;
+
+    // State of the newest recorded step (or of the last restored one), which
+    // the next delta is taken against.
+    std::vector<MoleculeState> current_;
+    std::mt19937               current_rng_;
+    ReactorScalars             current_scalars_;
+    std::vector<MoleculeState> scratch_;
+
+    void addKeyframe (const Reactor& reactor);
+    bool addDelta    (const Reactor& reactor);
+    void truncateAfter(long long step);
+    void enforceBudget();
+    static void applyDelta(const StepRecord& delta, std::vector<MoleculeState>& state);
+    static size_t recordBytes(const StepRecord& record);
+
+public:
+    explicit ReactorHistory(size_t keyframeInterval = 120, size_t memoryBudget = 256 << 20);
+
+    void   setKeyframeInterval(size_t steps) { keyframe_interval_ = std::max<size_t>(1, steps); }
+    void   setMemoryBudget    (size_t bytes) { memory_budget_ = bytes; enforceBudget(); }
+    size_t getMemoryUsage     () const { return bytes_; }
+
+    void record (const Reactor& reactor);
+    // Puts the reactor back to the end of `step`; false if not recorded.
+    bool restore(Reactor& reactor, long long step);
+    void clear  ();
+
+    bool      empty       () const { return segments_.empty(); }
+    long long getFirstStep() const;
+    long long getLastStep () const;
+    // Last recorded step at or before `time`, clamped to the recorded range.
+    long long stepAtTime  (double time) const;
+    double    timeOfStep  (long long step) const;
+};
+
+#endif // REACTOR_HISTORY_HPP
@@ -1,6 +1,13 @@
 // ReactorRenderer.cpp
 #include "ReactorRenderer.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const size_t MOLECULE_GRAIN = 4096;
+const size_t ROW_GRAIN      = 16;
+}
 
 ReactorRenderer::ReactorRenderer(Reactor& reactor) : reactor_(reactor) {
     updateGraphics();
@@ -26,9 +33,82 @@ void ReactorRenderer::updateGraphics() {
     bottom_wall_.setSize(sf::Vector2f(reactor_.getReactorWidth(), reactor_.getWallThickness()));
     bottom_wall_.setPosition(reactor_.getReactorX(), reactor_.getReactorY() + reactor_.getReactorHeight() - reactor_.getWallThickness());
     bottom_wall_.setFillColor(sf::Color::White);
+
+    if (!display_fixed_) {
+        display_rect_ = sf::FloatRect(reactor_.getReactorX(), reactor_.getReactorY(),
+                                      reactor_.getReactorWidth(), reactor_.getReactorHeight());
+    }
+    fitCamera();
+}
+
+void ReactorRenderer::setDisplayRect(const sf::FloatRect& rect) {
+    display_rect_  = rect;
+    display_fixed_ = true;
+    fitCamera();
+}
+
+void ReactorRenderer::fitCamera() {
+    if (camera_user_) return;
+
+    float width  = std::max(1.f, static_cast<float>(reactor_.getReactorWidth()));
+    float height = std::max(1.f, static_cast<float>(reactor_.getReactorHeight()));
+    zoom_ = std::min({1.f, display_rect_.width / width, display_rect_.height / height});
+    if (zoom_ <= 0) zoom_ = 1.f;
+
+    camera_center_ = sf::Vector2f(reactor_.getReactorX() + display_rect_.width  / (2 * zoom_),
+                                  reactor_.getReactorY() + display_rect_.height / (2 * zoom_));
+}
+
+void ReactorRenderer::zoomAt(const sf::Vector2f& screen, float factor) {
+    sf::Vector2f anchor = screenToWorld(screen);
+
+    zoom_ = std::clamp(zoom_ * factor, 1e-3f, 64.f);
+    camera_center_ = sf::Vector2f(
+        anchor.x - (screen.x - display_rect_.left - display_rect_.width  / 2) / zoom_,
+        anchor.y - (screen.y - display_rect_.top  - display_rect_.height / 2) / zoom_);
+    camera_user_ = true;
+}
+
+void ReactorRenderer::pan(const sf::Vector2f& screenDelta) {
+    camera_center_ = sf::Vector2f(camera_center_.x - screenDelta.x / zoom_,
+                                  camera_center_.y - screenDelta.y / zoom_);
+    camera_user_ = true;
+}
+
+void ReactorRenderer::resetCamera() {
+    camera_user_ = false;
+    fitCamera();
+}
+
+sf::Vector2f ReactorRenderer::screenToWorld(const sf::Vector2f& screen) const {
+    sf::FloatRect visible = getVisibleWorldRect();
+    return sf::Vector2f(visible.left + (screen.x - display_rect_.left) / zoom_,
+                        visible.top  + (screen.y - display_rect_.top ) / zoom_);
+}
+
+sf::Vector2f ReactorRenderer::worldToScreen(const sf::Vector2f& world) const {
+    sf::FloatRect visible = getVisibleWorldRect();
+    return sf::Vector2f(display_rect_.left + (world.x - visible.left) * zoom_,
+                        display_rect_.top  + (world.y - visible.top ) * zoom_);
+}
+
+sf::FloatRect ReactorRenderer::getVisibleWorldRect() const {
+    float width  = display_rect_.width  / zoom_;
+    float height = display_rect_.height / zoom_;
+    return sf::FloatRect(camera_center_.x - width / 2, camera_center_.y - height / 2, width, height);
 }
 
 void ReactorRenderer::render(sf::RenderWindow& window) {
+    sf::View previous = window.getView();
+    sf::Vector2u size = window.getSize();
+
+    sf::View view(getVisibleWorldRect());
+    if (size.x > 0 && size.y > 0) {
+        view.setViewport(sf::FloatRect(display_rect_.left  / size.x, display_rect_.top    / size.y,
+                                       display_rect_.width / size.x, display_rect_.height / size.y));
+    }
+    window.setView(view);
+
     window.draw(reactor_bg_);
     
     left_wall_.setFillColor(getLeftWallColor());
@@ -37,7 +117,13 @@ void ReactorRenderer::render(sf::RenderWindow& window) {
     window.draw(top_wall_);
     window.draw(bottom_wall_);
 
-    drawMolecules(window);
+    if (render_mode_ == MoleculeRenderMode::Splat) {
+        drawMoleculesSplat(window);
+    } else {
+        drawMolecules(window);
+    }
+
+    window.setView(previous);
 }
 
 sf::Color ReactorRenderer::getLeftWallColor() const {
@@ -58,8 +144,14 @@ sf::Color ReactorRenderer::getWallColorBasedOnHits() const {
 }
 
 void ReactorRenderer::drawMolecules(sf::RenderWindow& window) {
-    for (const auto& mol : reactor_.getMolecules()) {
-        if (!mol) continue;
+    const auto& molecules = reactor_.getMolecules();
+    sf::FloatRect visible = getVisibleWorldRect();
+
+    reactor_.getSpatialGrid().forEachInRect(visible.left, visible.top,
+                                            visible.left + visible.width, visible.top + visible.height,
+                                            [&](size_t index) {
+        if (index >= molecules.size() || !molecules[index]) return;
+        const auto& mol = molecules[index];
         
         Vector2f pos = mol->getPosition();
         if (mol->getType() == MoleculeType::Round) {
@@ -81,5 +173,221 @@ void ReactorRenderer::drawMolecules(sf::RenderWindow& window) {
                 window.draw(square);
             }
         }
+    });
+}
+
+sf::FloatRect ReactorRenderer::getInteriorRect() const {
+    float wall = reactor_.getWallThickness();
+    return sf::FloatRect(reactor_.getReactorX() + wall, reactor_.getReactorY() + wall,
+                         std::max(0.f, static_cast<float>(reactor_.getReactorWidth()  - 2 * wall)),
+                         std::max(0.f, static_cast<float>(reactor_.getReactorHeight() - 2 * wall)));
+}
+
+void ReactorRenderer::drawMoleculesSplat(sf::RenderWindow& window) {
+    const auto& molecules = reactor_.getMolecules();
+    sf::FloatRect interior = getInteriorRect();
+    sf::FloatRect visible  = getVisibleWorldRect();
+
+    // Rasterise only the visible part of the interior, at screen resolution.
+    float left   = std::max(interior.left, visible.left);
+    float top    = std::max(interior.top,  visible.top);
+    float right  = std::min(interior.left + interior.width,  visible.left + visible.width);
+    float bottom = std::min(interior.top  + interior.height, visible.top  + visible.height);
+    if (right <= left || bottom <= top) return;
+
+    splat_rect_  = sf::FloatRect(left, top, right - left, bottom - top);
+    splat_scale_ = zoom_;
+
+    unsigned width  = static_cast<unsigned>(std::ceil(splat_rect_.width  * splat_scale_));
+    unsigned height = static_cast<unsigned>(std::ceil(splat_rect_.height * splat_scale_));
+    if (width == 0 || height == 0) return;
+
+    float interiorPixels = interior.width * interior.height * zoom_ * zoom_;
+    if (molecules.size() > heatmap_threshold_ * interiorPixels) {
+        drawMoleculesHeatmap(window);
+        return;
+    }
+
+    JobSystem& jobs = reactor_.getJobSystem();
+
+    points_.resize(molecules.size());
+    jobs.parallelFor(molecules.size(), MOLECULE_GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& mol = molecules[i];
+            if (!mol) {
+                points_[i].half = -1;
+                continue;
+            }
+            Vector2f pos = mol->getPosition();
+            points_[i].x    = (pos.getX() - splat_rect_.left) * splat_scale_;
+            points_[i].y    = (pos.getY() - splat_rect_.top ) * splat_scale_;
+            points_[i].half = std::max(0.5f, static_cast<float>(mol->getSize().getX() / 2 * splat_scale_));
+            points_[i].type = mol->getType();
+        }
+    });
+
+    // Bucket the points by the bands of ROW_GRAIN rows they cover, so each
+    // band only visits its own; one straddling a band edge goes in both.
+    size_t bands = (height + ROW_GRAIN - 1) / ROW_GRAIN;
+    auto rowSpan = [&](const SplatPoint& p, int& y0, int& y1) {
+        if (p.half < 0) return false;
+        y0 = std::max(0,                        static_cast<int>(std::floor(p.y - p.half)));
+        y1 = std::min(static_cast<int>(height), static_cast<int>(std::ceil (p.y + p.half)));
+        return y0 < y1;
+    };
+
+    band_start_.assign(bands + 1, 0);
+    for (const auto& p : points_) {
+        int y0, y1;
+        if (!rowSpan(p, y0, y1)) continue;
+        for (size_t band = y0 / ROW_GRAIN; band <= (y1 - 1) / ROW_GRAIN; ++band) {
+            band_start_[band + 1]++;
+        }
+    }
+    for (size_t band = 0; band < bands; ++band) {
+        band_start_[band + 1] += band_start_[band];
+    }
+    band_fill_.assign(band_start_.begin(), band_start_.end() - 1);
+    band_points_.resize(band_start_[bands]);
+    for (size_t i = 0; i < points_.size(); ++i) {
+        int y0, y1;
+        if (!rowSpan(points_[i], y0, y1)) continue;
+        for (size_t band = y0 / ROW_GRAIN; band <= (y1 - 1) / ROW_GRAIN; ++band) {
+            band_points_[band_fill_[band]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    pixels_.resize(static_cast<size_t>(width) * height * 4);
+
+    // Each band owns its rows, so writes never overlap.
+    jobs.parallelFor(bands, 1, [&](size_t bandBegin, size_t bandEnd, size_t) {
+        for (size_t band = bandBegin; band < bandEnd; ++band) {
+            int rowBegin = static_cast<int>(band * ROW_GRAIN);
+            int rowEnd   = std::min(static_cast<int>(height), rowBegin + static_cast<int>(ROW_GRAIN));
+            std::memset(&pixels_[static_cast<size_t>(rowBegin) * width * 4], 0, static_cast<size_t>(rowEnd - rowBegin) * width * 4);
+
+            for (size_t k = band_start_[band]; k < band_start_[band + 1]; ++k) {
+                const SplatPoint& p = points_[band_points_[k]];
+
+                int y0, y1;
+                rowSpan(p, y0, y1);
+                y0 = std::max(y0, rowBegin);
+                y1 = std::min(y1, rowEnd);
+
+                int x0 = std::max(0,                       static_cast<int>(std::floor(p.x - p.half)));
+                int x1 = std::min(static_cast<int>(width), static_cast<int>(std::ceil (p.x + p.half)));
+
+                sf::Uint8 r = p.type == MoleculeType::Round ? 255 : 0;
+                sf::Uint8 b = r;
+                for (int y = y0; y < y1; ++y) {
+                    sf::Uint8* row = &pixels_[(static_cast<size_t>(y) * width) * 4];
+                    for (int x = x0; x < x1; ++x) {
+                        sf::Uint8* px = row + x * 4;
+                        px[0] = r;
+                        px[1] = 255;
+                        px[2] = b;
+                        px[3] = 255;
+                    }
+                }
+            }
+        }
+    });
+
+    uploadTexture(window, width, height, 1.f);
+}
+
+void ReactorRenderer::drawMoleculesHeatmap(sf::RenderWindow& window) {
+    const auto& molecules = reactor_.getMolecules();
+
+    unsigned gridW = static_cast<unsigned>(std::ceil(splat_rect_.width  * splat_scale_ / heatmap_cell_));
+    unsigned gridH = static_cast<unsigned>(std::ceil(splat_rect_.height * splat_scale_ / heatmap_cell_));
+    size_t   cells = static_cast<size_t>(gridW) * gridH;
+    if (cells == 0) return;
+
+    // One partial grid per worker, summed afterwards.
+    JobSystem& jobs = reactor_.getJobSystem();
+    size_t workers = jobs.getWorkerCount();
+    heat_cells_.assign(cells * workers, HeatCell());
+
+    jobs.parallelFor(molecules.size(), MOLECULE_GRAIN, [&](size_t begin, size_t end, size_t worker) {
+        HeatCell* grid = &heat_cells_[worker * cells];
+        float inv = splat_scale_ / heatmap_cell_;
+
+        for (size_t i = begin; i < end; ++i) {
+            const auto& mol = molecules[i];
+            if (!mol) continue;
+
+            Vector2f pos = mol->getPosition();
+            int cx = static_cast<int>(std::floor((pos.getX() - splat_rect_.left) * inv));
+            int cy = static_cast<int>(std::floor((pos.getY() - splat_rect_.top ) * inv));
+            if (cx < 0 || cy < 0 || cx >= static_cast<int>(gridW) || cy >= static_cast<int>(gridH)) continue;
+
+            HeatCell& cell = grid[static_cast<size_t>(cy) * gridW + cx];
+            Vector2f vel = mol->getVelocity();
+            cell.energy += 0.5f * mol->getMass() * (vel.getX() * vel.getX() + vel.getY() * vel.getY());
+            if (mol->getType() == MoleculeType::Round) cell.round++;
+            else                                       cell.square++;
+        }
+    });
+
+    float totalEnergy = 0, totalCount = 0;
+    for (size_t c = 0; c < cells; ++c) {
+        for (size_t w = 1; w < workers; ++w) {
+            const HeatCell& part = heat_cells_[w * cells + c];
+            heat_cells_[c].round  += part.round;
+            heat_cells_[c].square += part.square;
+            heat_cells_[c].energy += part.energy;
+        }
+        totalEnergy += heat_cells_[c].energy;
+        totalCount  += heat_cells_[c].round + heat_cells_[c].square;
     }
+
+    float meanTemp     = totalCount > 0 ? totalEnergy / totalCount : 0;
+    float cellCapacity = heatmap_threshold_ * heatmap_cell_ * heatmap_cell_;
+
+    pixels_.resize(cells * 4);
+    for (size_t c = 0; c < cells; ++c) {
+        const HeatCell& cell = heat_cells_[c];
+        float count = cell.round + cell.square;
+        sf::Uint8* px = &pixels_[c * 4];
+        if (count <= 0) {
+            px[0] = px[1] = px[2] = px[3] = 0;
+            continue;
+        }
+
+        float squareFrac = cell.square / count;
+        float brightness = std::min(1.f, 0.25f + 0.75f * std::sqrt(count / (4 * cellCapacity)));
+        float heat = meanTemp > 0 ? std::clamp(cell.energy / count / meanTemp - 1.f, -1.f, 1.f) : 0;
+
+        float r = 255 * (1 - squareFrac), g = 255, b = r;
+        if (heat > 0) {
+            r += (255 - r) * heat;
+            g *= 1 - 0.6f * heat;
+            b *= 1 - 0.6f * heat;
+        } else {
+            b += (255 - b) * -heat;
+            r *= 1 + 0.6f * heat;
+            g *= 1 + 0.6f * heat;
+        }
+
+        px[0] = static_cast<sf::Uint8>(r * brightness);
+        px[1] = static_cast<sf::Uint8>(g * brightness);
+        px[2] = static_cast<sf::Uint8>(b * brightness);
+        px[3] = 255;
+    }
+
+    uploadTexture(window, gridW, gridH, static_cast<float>(heatmap_cell_));
+}
+
+void ReactorRenderer::uploadTexture(sf::RenderWindow& window, unsigned width, unsigned height, float texelPixels) {
+    if (splat_texture_.getSize().x != width || splat_texture_.getSize().y != height) {
+        if (!splat_texture_.create(width, height)) return;
+    }
+    splat_texture_.update(pixels_.data());
+
+    // The sprite is placed in world coordinates under the camera view.
+    sf::Sprite sprite(splat_texture_);
+    sprite.setPosition(splat_rect_.left, splat_rect_.top);
+    sprite.setScale(texelPixels / splat_scale_, texelPixels / splat_scale_);
+    window.draw(sprite);
 }
\ No newline at end of file
@@ -4,22 +4,91 @@
 
 #include "Reactor.hpp"
 #include <SFML/Graphics.hpp>
+#include <vector>
+
+// Shapes draws one SFML shape per molecule. Splat rasterises molecules
+// into a pixel buffer uploaded as a single texture, and falls back to a
+// per-species density/temperature heatmap once the reactor gets crowded.
+enum class MoleculeRenderMode {
+    Shapes,
+    Splat
+};
 
 class ReactorRenderer {
 private:
+    struct SplatPoint {
+        float x, y;
+        float half;
+        MoleculeType type;
+    };
+
+    struct HeatCell {
+        float round  = 0;
+        float square = 0;
+        float energy = 0;
+    };
+
     Reactor& reactor_;
     sf::RectangleShape reactor_bg_;
     sf::RectangleShape left_wall_, right_wall_, top_wall_, bottom_wall_;
 
+    MoleculeRenderMode render_mode_ = MoleculeRenderMode::Shapes;
+    float heatmap_threshold_ = 0.25f;
+    int   heatmap_cell_      = 4;
+
+    // Screen area the reactor is shown in, and the camera looking at it.
+    // Until the user zooms or pans, the camera fits the reactor at 1:1.
+    sf::FloatRect display_rect_;
+    bool          display_fixed_ = false;
+    sf::Vector2f  camera_center_;
+    float         zoom_        = 1.f;
+    bool          camera_user_ = false;
+
+    sf::FloatRect              splat_rect_;
+    float                      splat_scale_ = 1.f;
+    std::vector<sf::Uint8>     pixels_;
+    std::vector<SplatPoint>    points_;
+    // Points of band b are band_points_[band_start_[b] .. band_start_[b + 1]).
+    std::vector<size_t>        band_start_;
+    std::vector<size_t>        band_fill_;
+    std::vector<std::uint32_t> band_points_;
+    std::vector<HeatCell>      heat_cells_;
+    sf::Texture                splat_texture_;
+
 public:
     ReactorRenderer    (Reactor& reactor);
     void updateGraphics();
     void render        (sf::RenderWindow& window);
 
+    void setRenderMode(MoleculeRenderMode mode) { render_mode_ = mode; }
+    MoleculeRenderMode getRenderMode() const    { return render_mode_; }
+
+    // Molecules per interior pixel above which Splat switches to the heatmap.
+    void  setHeatmapThreshold(float density) { heatmap_threshold_ = density; }
+    float getHeatmapThreshold() const        { return heatmap_threshold_; }
+    void  setHeatmapCellSize (int pixels)    { heatmap_cell_ = std::max(1, pixels); }
+
+    void          setDisplayRect(const sf::FloatRect& rect);
+    sf::FloatRect getDisplayRect() const { return display_rect_; }
+    bool          displayContains(const sf::Vector2f& screen) const { return display_rect_.contains(screen); }
+
+    void          zoomAt      (const sf::Vector2f& screen, float factor);
+    void          pan         (const sf::Vector2f& screenDelta);
+    void          resetCamera ();
+    float         getZoom     () const { return zoom_; }
+    sf::Vector2f  screenToWorld(const sf::Vector2f& screen) const;
+    sf::Vector2f  worldToScreen(const sf::Vector2f& world) const;
+    sf::FloatRect getVisibleWorldRect() const;
+
 private:
     sf::Color getLeftWallColor       () const;
     sf::Color getWallColorBasedOnHits() const;
     void drawMolecules               (sf::RenderWindow& window);
+    void drawMoleculesSplat          (sf::RenderWindow& window);
+    void drawMoleculesHeatmap        (sf::RenderWindow& window);
+    void uploadTexture               (sf::RenderWindow& window, unsigned width, unsigned height, float texelPixels);
+    sf::FloatRect getInteriorRect    () const;
+    void fitCamera                   ();
 };
 
 #endif // REACTOR_RENDERER_HPP
\ No newline at end of file
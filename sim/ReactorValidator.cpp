@@ -0,0 +1,186 @@
+// ReactorValidator.cpp
+#include "ReactorValidator.hpp"
+#include "Reactor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+double relativeError(double a, double b) {
+    double scale = std::max(std::abs(a), std::abs(b));
+    return scale > 0 ? std::abs(a - b) / scale : 0;
+}
+
+// Kinetic energy summed in double. The reactor's own energy history is a
+// Real sum in molecule order, which differs between engines (chunking,
+// reordering) by far more than the tolerance at large N even when every
+// molecule matches exactly.
+double kineticEnergy(const Reactor& reactor) {
+    double total = 0;
+    for (const auto& mol : reactor.getMolecules()) {
+        Vector2f vel = mol->getVelocity();
+        total += 0.5 * mol->getMass() * (static_cast<double>(vel.x) * vel.x + static_cast<double>(vel.y) * vel.y);
+    }
+    return total;
+}
+
+Divergence makeDivergence(long long step, const char* what, std::uint32_t id, double reference, double candidate) {
+    Divergence divergence;
+    divergence.step       = step;
+    divergence.what       = what;
+    divergence.moleculeId = id;
+    divergence.reference  = reference;
+    divergence.candidate  = candidate;
+    return divergence;
+}
+
+}
+
+ValidationReport ReactorValidator::run(const ValidationConfig& config,
+                                       const std::function<void(long long step)>& onStep) {
+    // One sim worker runs every loop, reductions included, as a single
+    // serial pass: the engine as it is without threads.
+    EnsembleConfig serial = config.reference;
+    serial.simWorkers = 1;
+    auto reference = EnsembleRunner::createReactor(serial);
+    auto candidate = EnsembleRunner::createReactor(config.candidate);
+
+    ValidationReport report;
+    report.first = compare(*reference, *candidate, config.tolerance, report);
+
+    int steps = std::min(config.reference.steps, config.candidate.steps);
+    for (int step = 0; step < steps && !report.first.diverged(); ++step) {
+        reference->update(config.reference.dt);
+        candidate->update(config.candidate.dt);
+        report.steps++;
+        report.first = compare(*reference, *candidate, config.tolerance, report);
+        if (onStep) onStep(report.steps);
+    }
+    return report;
+}
+
+Divergence ReactorValidator::compare(const Reactor& reference, const Reactor& candidate,
+                                     const ValidationTolerance& tolerance, ValidationReport& report) {
+    long long step = reference.getStepCount();
+    const auto& refMolecules  = reference.getMolecules();
+    const auto& candMolecules = candidate.getMolecules();
+
+    // Reaction counts come first, as they explain a differing population.
+    const ReactionStats::Counts& refCounts  = reference.getReactionStats().getLastStep();
+    const ReactionStats::Counts& candCounts = candidate.getReactionStats().getLastStep();
+    for (int a = 0; a < ReactionStats::TYPES; ++a) {
+        for (int b = 0; b < ReactionStats::TYPES; ++b) {
+            if (refCounts.detected[a][b] != candCounts.detected[a][b]) {
+                return makeDivergence(step, "detected reactions", 0, refCounts.detected[a][b], candCounts.detected[a][b]);
+            }
+            if (refCounts.executed[a][b] != candCounts.executed[a][b]) {
+                return makeDivergence(step, "executed reactions", 0, refCounts.executed[a][b], candCounts.executed[a][b]);
+            }
+            if (refCounts.deferred[a][b] != candCounts.deferred[a][b] ||
+                refCounts.rejected[a][b] != candCounts.rejected[a][b]) {
+                return makeDivergence(step, "deferred or rejected reactions", 0,
+                                      refCounts.deferred[a][b] + refCounts.rejected[a][b],
+                                      candCounts.deferred[a][b] + candCounts.rejected[a][b]);
+            }
+        }
+    }
+
+    if (refMolecules.size() != candMolecules.size()) {
+        return makeDivergence(step, "molecule count", 0, refMolecules.size(), candMolecules.size());
+    }
+
+    // Molecules are matched by id, so engines that reorder them compare
+    // fine. The first offender in reference order is reported.
+    Divergence first;
+    size_t off = 0;
+    double maxPosition = 0, maxVelocity = 0;
+    for (const auto& mol : refMolecules) {
+        size_t index = candidate.findById(mol->getId());
+        if (index == Reactor::NO_MOLECULE) {
+            if (off++ == 0) first = makeDivergence(step, "missing molecule", mol->getId(), mol->getId(), 0);
+            continue;
+        }
+        const Molecule& other = *candMolecules[index];
+
+        Vector2f dp = mol->getPosition() - other.getPosition();
+        Vector2f dv = mol->getVelocity() - other.getVelocity();
+        double position = std::max(std::abs(dp.x), std::abs(dp.y));
+        double velocity = std::max(std::abs(dv.x), std::abs(dv.y));
+        double mass     = std::abs(mol->getMass() - other.getMass());
+        maxPosition = std::max(maxPosition, position);
+        maxVelocity = std::max(maxVelocity, velocity);
+
+        const char* what = nullptr;
+        double refValue = 0, candValue = 0;
+        if (mol->getType() != other.getType()) {
+            what = "type";
+            refValue  = static_cast<int>(mol->getType());
+            candValue = static_cast<int>(other.getType());
+        } else if (mass > tolerance.mass) {
+            what = "mass";
+            refValue  = mol->getMass();
+            candValue = other.getMass();
+        } else if (position > tolerance.position) {
+            bool x = std::abs(dp.x) >= std::abs(dp.y);
+            what = x ? "position.x" : "position.y";
+            refValue  = x ? mol->getPosition().x : mol->getPosition().y;
+            candValue = x ? other.getPosition().x : other.getPosition().y;
+        } else if (velocity > tolerance.velocity) {
+            bool x = std::abs(dv.x) >= std::abs(dv.y);
+            what = x ? "velocity.x" : "velocity.y";
+            refValue  = x ? mol->getVelocity().x : mol->getVelocity().y;
+            candValue = x ? other.getVelocity().x : other.getVelocity().y;
+        }
+        if (what && off++ == 0) {
+            first = makeDivergence(step, what, mol->getId(), refValue, candValue);
+        }
+    }
+    if (off > 0) {
+        first.moleculesOff = off;
+        return first;
+    }
+    report.maxPositionError = std::max(report.maxPositionError, maxPosition);
+    report.maxVelocityError = std::max(report.maxVelocityError, maxVelocity);
+
+    if (reference.getTotalRightWallHits() != candidate.getTotalRightWallHits()) {
+        return makeDivergence(step, "right wall hits", 0, reference.getTotalRightWallHits(), candidate.getTotalRightWallHits());
+    }
+
+    double refEnergy  = kineticEnergy(reference);
+    double candEnergy = kineticEnergy(candidate);
+    double error = relativeError(refEnergy, candEnergy);
+    if (error > tolerance.relative) {
+        return makeDivergence(step, "energy", 0, refEnergy, candEnergy);
+    }
+    report.maxEnergyError = std::max(report.maxEnergyError, error);
+
+    // The reactors' own statistics, as updateStatistics() reduced them. A
+    // sum of N positive terms in Accum may be off by about N rounding
+    // steps, and differently so for each engine's summation order.
+    if (reference.getEnergyHistory().empty() || candidate.getEnergyHistory().empty()) {
+        return Divergence();
+    }
+    if (reference.getRoundMoleculeHistory().back() != candidate.getRoundMoleculeHistory().back()) {
+        return makeDivergence(step, "round count", 0, reference.getRoundMoleculeHistory().back(),
+                              candidate.getRoundMoleculeHistory().back());
+    }
+    if (reference.getSquareMoleculeHistory().back() != candidate.getSquareMoleculeHistory().back()) {
+        return makeDivergence(step, "square count", 0, reference.getSquareMoleculeHistory().back(),
+                              candidate.getSquareMoleculeHistory().back());
+    }
+
+    double summed = tolerance.relative + 2.0 * refMolecules.size() * std::numeric_limits<Accum>::epsilon();
+    double refStat  = reference.getEnergyHistory().back();
+    double candStat = candidate.getEnergyHistory().back();
+    if (relativeError(refStat, candStat) > summed) {
+        return makeDivergence(step, "energy statistic", 0, refStat, candStat);
+    }
+    refStat  = reference.getTemperatureHistory().back();
+    candStat = candidate.getTemperatureHistory().back();
+    if (relativeError(refStat, candStat) > summed) {
+        return makeDivergence(step, "temperature statistic", 0, refStat, candStat);
+    }
+
+    return Divergence();
+}
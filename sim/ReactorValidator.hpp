@@ -0,0 +1,62 @@
+// ReactorValidator.hpp
+#ifndef REACTOR_VALIDATOR_HPP
+#define REACTOR_VALIDATOR_HPP
+
+#include "Ensemble.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class Reactor;
+
+// Largest differences accepted between the reference and the candidate.
+// Molecule counts, ids, types and reaction counts must match exactly.
+struct ValidationTolerance {
+    float position = 1e-4f;   // reactor units
+    float velocity = 1e-4f;
+    float mass     = 1e-6f;
+    // Energy summed in double from the molecules; the reactors' energy and
+    // temperature statistics also get 2 * N * epsilon of their sum type.
+    float relative = 1e-5f;
+};
+
+struct ValidationConfig {
+    // Same scenario twice: the reference with the plain serial engine, the
+    // candidate with whatever engine options are under test.
+    EnsembleConfig      reference;
+    EnsembleConfig      candidate;
+    ValidationTolerance tolerance;
+};
+
+struct Divergence {
+    long long     step       = -1;   // -1 when the runs agreed throughout
+    std::string   what;              // e.g. "molecule count", "position.x"
+    std::uint32_t moleculeId = 0;    // 0 when not about a single molecule
+    double        reference  = 0;
+    double        candidate  = 0;
+    size_t        moleculesOff = 0;  // molecules out of tolerance at that step
+
+    bool diverged() const { return step >= 0; }
+};
+
+struct ValidationReport {
+    long long  steps = 0;
+    Divergence first;
+    // Worst differences seen while the runs still agreed.
+    double     maxPositionError = 0;
+    double     maxVelocityError = 0;
+    double     maxEnergyError   = 0;   // relative
+};
+
+// Steps both reactors in lockstep and stops at the first divergence.
+class ReactorValidator {
+public:
+    static ValidationReport run(const ValidationConfig& config,
+                                const std::function<void(long long step)>& onStep = {});
+
+    // Compares the state after a step; `report` collects the max errors.
+    static Divergence compare(const Reactor& reference, const Reactor& candidate,
+                              const ValidationTolerance& tolerance, ValidationReport& report);
+};
+
+#endif // REACTOR_VALIDATOR_HPP
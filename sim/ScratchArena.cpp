@@ -0,0 +1,60 @@
+// ScratchArena.cpp
+#include "ScratchArena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+ScratchArena::ScratchArena(size_t initialBytes) {
+    addBlock(std::max<size_t>(initialBytes, 256));
+}
+
+void ScratchArena::addBlock(size_t size) {
+    Block block;
+    block.data.reset(new unsigned char[size]);
+    block.size = size;
+    blocks_.push_back(std::move(block));
+    heap_allocations_++;
+}
+
+void* ScratchArena::allocate(size_t bytes, size_t alignment) {
+    auto alignedOffset = [&](const Block& block) {
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        return static_cast<size_t>(((base + used_ + alignment - 1) & ~(std::uintptr_t(alignment) - 1)) - base);
+    };
+
+    size_t offset = alignedOffset(blocks_.back());
+    if (offset + bytes > blocks_.back().size) {
+        size_t size = std::max(blocks_.back().size * 2, bytes + alignment);
+        filled_ += blocks_.back().size;
+        used_ = 0;
+        addBlock(size);
+        offset = alignedOffset(blocks_.back());
+    }
+
+    used_ = offset + bytes;
+    peak_ = std::max(peak_, filled_ + used_);
+    return blocks_.back().data.get() + offset;
+}
+
+void ScratchArena::deallocate(void* pointer, size_t bytes) {
+    unsigned char* begin = blocks_.back().data.get();
+    unsigned char* end   = static_cast<unsigned char*>(pointer) + bytes;
+    if (end == begin + used_) {
+        used_ = static_cast<size_t>(static_cast<unsigned char*>(pointer) - begin);
+    }
+}
+
+void ScratchArena::reset() {
+    if (blocks_.size() > 1) {
+        size_t total = getCapacity();
+        blocks_.clear();
+        addBlock(total);
+    }
+    used_   = 0;
+    filled_ = 0;
+}
+
+size_t ScratchArena::getCapacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks_) total += block.size;
+    return total;
+}
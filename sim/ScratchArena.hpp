@@ -0,0 +1,80 @@
+// ScratchArena.hpp
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump allocator for data that lives no longer than one step or frame.
+// Allocating moves a pointer; nothing is freed until reset(), which the
+// owner calls once the step is over. When a step overflows the first
+// block, more blocks are chained on and reset() merges them into one
+// block of the combined size, so after a few steps of warm-up the arena
+// stops touching the heap.
+//
+// Not thread safe: use it from the thread that owns the step.
+class ScratchArena {
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t                           size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    size_t used_   = 0;            // bytes taken from blocks_.back()
+    size_t filled_ = 0;            // bytes of the blocks before it
+    size_t peak_   = 0;            // most bytes in use during one step
+    size_t heap_allocations_ = 0;
+
+    void addBlock(size_t size);
+
+public:
+    explicit ScratchArena(size_t initialBytes = 64 << 10);
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    void* allocate  (size_t bytes, size_t alignment);
+    // Only the most recent allocation is given back; anything else waits
+    // for reset(). Lets a growing vector reuse its old space.
+    void  deallocate(void* pointer, size_t bytes);
+    void  reset     ();
+
+    size_t getCapacity       () const;
+    size_t getPeakUsage      () const { return peak_; }
+    size_t getHeapAllocations() const { return heap_allocations_; }
+};
+
+// std-compatible allocator over a ScratchArena, for containers that are
+// dropped before the arena is reset.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ScratchArena& arena) noexcept : arena_(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* pointer, size_t count) noexcept {
+        arena_->deallocate(pointer, count * sizeof(T));
+    }
+
+    ScratchArena* arena() const noexcept { return arena_; }
+
+private:
+    ScratchArena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() == b.arena(); }
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() != b.arena(); }
+
+template<typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // SCRATCH_ARENA_HPP
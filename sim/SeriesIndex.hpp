@@ -0,0 +1,136 @@
+// SeriesIndex.hpp
+#ifndef SERIES_INDEX_HPP
+#define SERIES_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Append-only time series with a min/max/sum pyramid over it, so any
+// index range can be summarised in O(log n). Level k holds one node per
+// complete run of 2^(k+1) samples; a push or pop touches one node per
+// level at most and O(1) amortised. The pyramid costs about as much
+// memory again as the samples do.
+template<typename T>
+class SeriesIndex {
+public:
+    struct Summary {
+        T      min   = std::numeric_limits<T>::max();
+        T      max   = std::numeric_limits<T>::lowest();
+        double sum   = 0;
+        size_t count = 0;
+
+        double mean () const { return count ? sum / count : 0; }
+        bool   empty() const { return count == 0; }
+    };
+
+private:
+    struct Node {
+        T      min, max;
+        double sum;
+    };
+
+    std::vector<T>                 values_;
+    std::vector<std::vector<Node>> levels_;
+
+    static Node combine(const Node& a, const Node& b) {
+        return Node{std::min(a.min, b.min), std::max(a.max, b.max), a.sum + b.sum};
+    }
+
+    static void add(Summary& summary, T value) {
+        summary.min = std::min(summary.min, value);
+        summary.max = std::max(summary.max, value);
+        summary.sum += value;
+        summary.count++;
+    }
+
+    static void add(Summary& summary, const Node& node, size_t count) {
+        summary.min = std::min(summary.min, node.min);
+        summary.max = std::max(summary.max, node.max);
+        summary.sum += node.sum;
+        summary.count += count;
+    }
+
+    void pushNode(size_t level, const Node& node) {
+        if (levels_.size() <= level) levels_.emplace_back();
+        std::vector<Node>& nodes = levels_[level];
+        nodes.push_back(node);
+        if (nodes.size() % 2 == 0) {
+            pushNode(level + 1, combine(nodes[nodes.size() - 2], nodes.back()));
+        }
+    }
+
+    void popNode(size_t level) {
+        std::vector<Node>& nodes = levels_[level];
+        bool paired = nodes.size() % 2 == 0;
+        nodes.pop_back();
+        if (paired) popNode(level + 1);
+    }
+
+public:
+    void push_back(T value) {
+        values_.push_back(value);
+        size_t n = values_.size();
+        if (n % 2 == 0) {
+            T a = values_[n - 2];
+            pushNode(0, Node{std::min(a, value), std::max(a, value), static_cast<double>(a) + value});
+        }
+    }
+
+    void pop_back() {
+        bool paired = values_.size() % 2 == 0;
+        values_.pop_back();
+        if (paired) popNode(0);
+    }
+
+    void clear() {
+        values_.clear();
+        levels_.clear();
+    }
+
+    // Drops the oldest `count` samples. The pyramid is rebuilt, so trim in
+    // large batches to keep pushes O(1) amortised.
+    void erase_front(size_t count) {
+        count = std::min(count, values_.size());
+        std::vector<T> kept(values_.begin() + count, values_.end());
+        clear();
+        values_.reserve(kept.size());
+        for (T value : kept) {
+            push_back(value);
+        }
+    }
+
+    void reserve(size_t count) { values_.reserve(count); }
+
+    size_t size () const { return values_.size(); }
+    bool   empty() const { return values_.empty(); }
+    T operator[](size_t index) const { return values_[index]; }
+    T back      () const { return values_.back(); }
+
+    // Min, max and sum of the samples in [begin, end).
+    Summary query(size_t begin, size_t end) const {
+        Summary summary;
+        end = std::min(end, values_.size());
+        if (begin >= end) return summary;
+
+        if (begin & 1) add(summary, values_[begin++]);
+        if (end   & 1) add(summary, values_[--end]);
+        begin >>= 1;
+        end   >>= 1;
+
+        // Every node taken below lies inside [begin, end) of the samples,
+        // so it is complete and exists.
+        size_t span = 2;
+        for (size_t level = 0; begin < end; ++level, span <<= 1) {
+            const std::vector<Node>& nodes = levels_[level];
+            if (begin & 1) add(summary, nodes[begin++], span);
+            if (end   & 1) add(summary, nodes[--end],   span);
+            begin >>= 1;
+            end   >>= 1;
+        }
+        return summary;
+    }
+};
+
+#endif // SERIES_INDEX_HPP
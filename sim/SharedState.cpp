@@ -0,0 +1,146 @@
+// SharedState.cpp
+#include "SharedState.hpp"
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHARED_STATE_POSIX 1
+#endif
+
+using namespace SharedStateFormat;
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+SharedSlotLayout::SharedSlotLayout(size_t capacity) {
+    size_t array = alignUp(capacity * sizeof(float), 64);
+    x    = alignUp(sizeof(SharedFrameHeader), 64);
+    y    = x  + array;
+    vx   = y  + array;
+    vy   = vx + array;
+    mass = vy + array;
+    type = mass + array;
+    size = alignUp(type + capacity, PAGE);
+}
+
+bool SharedFrame::stillValid() const {
+    if (!header) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header->sequence.load(std::memory_order_relaxed) == 2 * sequence;
+}
+
+SharedStateReader::~SharedStateReader() {
+    close();
+}
+
+bool SharedStateReader::open(const std::string& name) {
+    close();
+    name_ = name;
+
+#ifdef SHARED_STATE_POSIX
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < PAGE) {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return false;
+
+    base_ = static_cast<const std::uint8_t*>(address);
+    size_ = static_cast<size_t>(info.st_size);
+    header_ = reinterpret_cast<const SharedStateHeader*>(base_);
+
+    if (header_->magic != MAGIC || header_->version != VERSION || header_->headerSize != PAGE ||
+        header_->slotCount == 0 || PAGE + header_->slotCount * header_->slotSize > size_ ||
+        SharedSlotLayout(header_->capacity).size != header_->slotSize) {
+        close();
+        return false;
+    }
+    last_ = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SharedStateReader::close() {
+#ifdef SHARED_STATE_POSIX
+    if (base_) {
+        munmap(const_cast<std::uint8_t*>(base_), size_);
+    }
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+}
+
+std::uint64_t SharedStateReader::getLatestSequence() const {
+    return header_ ? header_->latest.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedStateReader::mapFrame(std::uint64_t sequence, SharedFrame& frame) const {
+    const std::uint8_t* slot = base_ + PAGE + ((sequence - 1) % header_->slotCount) * header_->slotSize;
+    const SharedFrameHeader* frameHeader = reinterpret_cast<const SharedFrameHeader*>(slot);
+    if (frameHeader->sequence.load(std::memory_order_acquire) != 2 * sequence) return false;
+
+    SharedSlotLayout layout(header_->capacity);
+    frame.sequence = sequence;
+    frame.header   = frameHeader;
+    frame.count    = static_cast<std::uint32_t>(std::min<std::uint64_t>(frameHeader->count, header_->capacity));
+    frame.x        = reinterpret_cast<const float*>(slot + layout.x);
+    frame.y        = reinterpret_cast<const float*>(slot + layout.y);
+    frame.vx       = reinterpret_cast<const float*>(slot + layout.vx);
+    frame.vy       = reinterpret_cast<const float*>(slot + layout.vy);
+    frame.mass     = reinterpret_cast<const float*>(slot + layout.mass);
+    frame.type     = slot + layout.type;
+    return frame.stillValid();
+}
+
+bool SharedStateReader::latest(SharedFrame& frame) {
+    if (!header_) return false;
+
+    std::uint64_t newest = getLatestSequence();
+    if (newest == 0 || newest <= last_) return false;
+
+    frame.dropped = last_ ? newest - last_ - 1 : 0;
+    if (!mapFrame(newest, frame)) return false;
+    last_ = newest;
+    return true;
+}
+
+bool SharedStateReader::next(SharedFrame& frame) {
+    if (!header_) return false;
+
+    // The writer may lap us between reading `latest` and the slot; retry a
+    // few times from the then-oldest frame before giving up.
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        std::uint64_t newest = getLatestSequence();
+        if (newest == 0 || newest <= last_) return false;
+
+        // The oldest slot is the one the writer fills next, so skip it.
+        std::uint64_t slots  = header_->slotCount;
+        std::uint64_t oldest = newest >= slots ? newest - slots + 2 : 1;
+        std::uint64_t wanted = last_ ? last_ + 1 : newest;
+        if (wanted < oldest) wanted = oldest;
+
+        if (mapFrame(wanted, frame)) {
+            frame.dropped = last_ ? wanted - last_ - 1 : 0;
+            last_ = wanted;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,113 @@
+// SharedState.hpp
+#ifndef SHARED_STATE_HPP
+#define SHARED_STATE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Layout of the shared-memory ring written by SharedStateExporter. The
+// segment starts with a SharedStateHeader page followed by `slotCount`
+// page-aligned slots; each slot is a SharedFrameHeader plus structure-of-
+// arrays molecule data (x, y, vx, vy, mass as float, type as uint8).
+//
+// Each slot is a seqlock: the writer makes `sequence` odd, fills the slot,
+// then stores the frame's even sequence number. A reader checks the number
+// before and after using the data; a mismatch means the writer lapped it.
+// The writer never waits on readers.
+namespace SharedStateFormat {
+    const std::uint32_t MAGIC   = 0x4d485352; // "RSHM"
+    const std::uint32_t VERSION = 1;
+    const size_t        PAGE    = 4096;
+
+    enum FrameFlags : std::uint32_t {
+        TRUNCATED = 1 // more molecules than the slot capacity; the rest were dropped
+    };
+}
+
+struct SharedStateHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t slotCount;
+    std::uint64_t slotSize;
+    std::uint64_t capacity;
+    std::uint64_t writerPid;
+    // Sequence number of the newest complete frame (0: none yet).
+    std::atomic<std::uint64_t> latest;
+};
+
+struct SharedFrameHeader {
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t step;
+    double        simTime;
+    std::uint32_t count;
+    std::uint32_t flags;
+    std::uint32_t roundCount;
+    std::uint32_t squareCount;
+    float         energy;
+    float         temperature;
+    float         leftWallTemperature;
+    float         reactorX, reactorY, reactorWidth, reactorHeight;
+    std::uint32_t reserved;
+};
+
+// A frame mapped in place. The pointers stay valid while the reader is
+// open, but the contents are only trustworthy while stillValid() holds.
+struct SharedFrame {
+    std::uint64_t             sequence = 0;
+    std::uint64_t             dropped  = 0;   // frames skipped since the previous next()
+    const SharedFrameHeader*  header   = nullptr;
+    const float*              x        = nullptr;
+    const float*              y        = nullptr;
+    const float*              vx       = nullptr;
+    const float*              vy       = nullptr;
+    const float*              mass     = nullptr;
+    const std::uint8_t*       type     = nullptr;
+    std::uint32_t             count    = 0;
+
+    // False once the writer has started overwriting this slot.
+    bool stillValid() const;
+};
+
+// Byte offsets of the arrays inside a slot.
+struct SharedSlotLayout {
+    size_t x, y, vx, vy, mass, type, size;
+
+    explicit SharedSlotLayout(size_t capacity);
+};
+
+// Maps a ring read-only; consumers link only this (ReactorShmReader).
+class SharedStateReader {
+private:
+    std::string                  name_;
+    const std::uint8_t*          base_ = nullptr;
+    size_t                       size_ = 0;
+    const SharedStateHeader*     header_ = nullptr;
+    std::uint64_t                last_ = 0;
+
+    bool mapFrame(std::uint64_t sequence, SharedFrame& frame) const;
+
+public:
+    SharedStateReader() = default;
+    ~SharedStateReader();
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    // `name` is a POSIX shm name such as "/reactor".
+    bool open (const std::string& name);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    const SharedStateHeader* getHeader() const { return header_; }
+    std::uint64_t            getLatestSequence() const;
+
+    // Newest complete frame, if there is one newer than the last returned.
+    bool latest(SharedFrame& frame);
+    // The frame after the last returned one; if that was already
+    // overwritten, the oldest still in the ring, with `dropped` set.
+    bool next  (SharedFrame& frame);
+};
+
+#endif // SHARED_STATE_HPP
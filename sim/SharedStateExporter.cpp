@@ -0,0 +1,140 @@
+// SharedStateExporter.cpp
+#include "SharedStateExporter.hpp"
+#include "Reactor.hpp"
+#include <algorithm>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHARED_STATE_POSIX 1
+#endif
+
+using namespace SharedStateFormat;
+
+SharedStateExporter::~SharedStateExporter() {
+    close();
+}
+
+bool SharedStateExporter::open(const std::string& name, size_t capacity, size_t slots) {
+    close();
+
+#ifdef SHARED_STATE_POSIX
+    capacity = std::max<size_t>(1, capacity);
+    slots    = std::max<size_t>(2, slots);
+    SharedSlotLayout layout(capacity);
+    size_t total = PAGE + slots * layout.size;
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* address = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    name_ = name;
+    base_ = static_cast<std::uint8_t*>(address);
+    size_ = total;
+    sequence_ = 0;
+
+    for (size_t s = 0; s < slots; ++s) {
+        auto* frame = new (base_ + PAGE + s * layout.size) SharedFrameHeader();
+        frame->sequence.store(0, std::memory_order_relaxed);
+    }
+
+    header_ = new (base_) SharedStateHeader();
+    header_->headerSize = static_cast<std::uint32_t>(PAGE);
+    header_->slotCount  = static_cast<std::uint32_t>(slots);
+    header_->slotSize   = layout.size;
+    header_->capacity   = capacity;
+    header_->writerPid  = static_cast<std::uint64_t>(getpid());
+    header_->version    = VERSION;
+    header_->latest.store(0, std::memory_order_relaxed);
+    // Readers check the magic first; it goes in last.
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic      = MAGIC;
+    return true;
+#else
+    (void)name;
+    (void)capacity;
+    (void)slots;
+    return false;
+#endif
+}
+
+void SharedStateExporter::close() {
+#ifdef SHARED_STATE_POSIX
+    if (base_) {
+        munmap(base_, size_);
+        shm_unlink(name_.c_str());
+    }
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+}
+
+void SharedStateExporter::publish(const Reactor& reactor) {
+    if (!header_) return;
+
+    std::uint64_t sequence = ++sequence_;
+    SharedSlotLayout layout(header_->capacity);
+    std::uint8_t* slot = base_ + PAGE + ((sequence - 1) % header_->slotCount) * header_->slotSize;
+    auto* frame = reinterpret_cast<SharedFrameHeader*>(slot);
+
+    frame->sequence.store(2 * sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const auto& molecules = reactor.getMolecules();
+    size_t count = std::min<size_t>(molecules.size(), header_->capacity);
+
+    float*        x    = reinterpret_cast<float*>(slot + layout.x);
+    float*        y    = reinterpret_cast<float*>(slot + layout.y);
+    float*        vx   = reinterpret_cast<float*>(slot + layout.vx);
+    float*        vy   = reinterpret_cast<float*>(slot + layout.vy);
+    float*        mass = reinterpret_cast<float*>(slot + layout.mass);
+    std::uint8_t* type = slot + layout.type;
+
+    std::uint32_t round = 0, square = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Molecule& mol = *molecules[i];
+        Vector2f pos = mol.getPosition();
+        Vector2f vel = mol.getVelocity();
+        x[i]    = pos.x;
+        y[i]    = pos.y;
+        vx[i]   = vel.x;
+        vy[i]   = vel.y;
+        mass[i] = mol.getMass();
+        type[i] = static_cast<std::uint8_t>(mol.getType());
+        if (mol.getType() == MoleculeType::Round) round++;
+        else                                      square++;
+    }
+
+    frame->step                = static_cast<std::uint64_t>(reactor.getStepCount());
+    frame->simTime             = reactor.getSimTime();
+    frame->count               = static_cast<std::uint32_t>(count);
+    frame->flags               = molecules.size() > count ? static_cast<std::uint32_t>(TRUNCATED) : 0u;
+    frame->roundCount          = round;
+    frame->squareCount         = square;
+    frame->energy              = reactor.getEnergyHistory     ().empty() ? 0 : reactor.getEnergyHistory     ().back();
+    frame->temperature         = reactor.getTemperatureHistory().empty() ? 0 : reactor.getTemperatureHistory().back();
+    frame->leftWallTemperature = reactor.getLeftWallTemperature();
+    frame->reactorX            = reactor.getReactorX();
+    frame->reactorY            = reactor.getReactorY();
+    frame->reactorWidth        = reactor.getReactorWidth();
+    frame->reactorHeight       = reactor.getReactorHeight();
+
+    frame->sequence.store(2 * sequence, std::memory_order_release);
+    header_->latest.store(sequence, std::memory_order_release);
+}
@@ -0,0 +1,39 @@
+// SharedStateExporter.hpp
+#ifndef SHARED_STATE_EXPORTER_HPP
+#define SHARED_STATE_EXPORTER_HPP
+
+#include "SharedState.hpp"
+#include <string>
+
+class Reactor;
+
+// Publishes each step of a Reactor into a POSIX shared-memory ring (see
+// SharedState.hpp); Reactor::enableSharedExport owns one. Slots hold up to `capacity` molecules;
+// larger frames are cut off and flagged TRUNCATED.
+class SharedStateExporter {
+private:
+    std::string        name_;
+    std::uint8_t*      base_ = nullptr;
+    size_t             size_ = 0;
+    SharedStateHeader* header_ = nullptr;
+    std::uint64_t      sequence_ = 0;
+
+public:
+    SharedStateExporter() = default;
+    ~SharedStateExporter();
+    SharedStateExporter(const SharedStateExporter&) = delete;
+    SharedStateExporter& operator=(const SharedStateExporter&) = delete;
+
+    // Replaces any existing segment of that name; readers still mapping
+    // the old one keep it until they close.
+    bool open (const std::string& name, size_t capacity, size_t slots = 8);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    void publish(const Reactor& reactor);
+
+    const std::string& getName    () const { return name_; }
+    std::uint64_t      getSequence() const { return sequence_; }
+};
+
+#endif // SHARED_STATE_EXPORTER_HPP
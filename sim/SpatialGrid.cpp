@@ -0,0 +1,48 @@
+// SpatialGrid.cpp
+#include "SpatialGrid.hpp"
+#include "Reactor.hpp"
+
+void SpatialGrid::build(const std::vector<std::unique_ptr<Molecule>>& molecules,
+                        Real x, Real y, Real width, Real height, Real cellSize) {
+    const int MAX_CELLS_PER_AXIS = 4096;
+
+    originX_  = x;
+    originY_  = y;
+    cellSize_ = std::max(cellSize, std::max(width, height) / MAX_CELLS_PER_AXIS);
+    cols_     = std::max(1, static_cast<int>(std::ceil(width  / cellSize_)));
+    rows_     = std::max(1, static_cast<int>(std::ceil(height / cellSize_)));
+    maxHalfExtent_ = 0;
+
+    size_t cells = static_cast<size_t>(cols_) * rows_;
+    cellStart_.assign(cells + 1, 0);
+    cellOf_.resize(molecules.size());
+
+    unsigned count = 0;
+    for (size_t i = 0; i < molecules.size(); ++i) {
+        const auto& mol = molecules[i];
+        if (!mol) {
+            cellOf_[i] = static_cast<unsigned>(cells);
+            continue;
+        }
+
+        Vector2f pos = mol->getPosition();
+        unsigned cell = static_cast<unsigned>(cellY(pos.getY())) * cols_ + cellX(pos.getX());
+        cellOf_[i] = cell;
+        cellStart_[cell + 1]++;
+        count++;
+
+        maxHalfExtent_ = std::max(maxHalfExtent_, mol->getSize().getX() / 2);
+    }
+
+    for (size_t c = 0; c < cells; ++c) {
+        cellStart_[c + 1] += cellStart_[c];
+    }
+
+    entries_.resize(count);
+    cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (size_t i = 0; i < molecules.size(); ++i) {
+        if (cellOf_[i] < cells) {
+            entries_[cursor_[cellOf_[i]]++] = static_cast<unsigned>(i);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+// SpatialGrid.hpp
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include "Precision.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class Molecule;
+
+// Uniform bucket grid over molecule indices, rebuilt with a counting sort.
+// Cells are stored CSR style: the indices of cell c live in
+// entries_[cellStart_[c] .. cellStart_[c + 1]).
+class SpatialGrid {
+private:
+    Real originX_ = 0, originY_ = 0;
+    Real cellSize_ = 1;
+    int  cols_ = 0, rows_ = 0;
+    Real maxHalfExtent_ = 0;
+
+    std::vector<unsigned> cellStart_;
+    std::vector<unsigned> entries_;
+    std::vector<unsigned> cellOf_;
+    std::vector<unsigned> cursor_;
+
+public:
+    void build(const std::vector<std::unique_ptr<Molecule>>& molecules,
+               Real x, Real y, Real width, Real height, Real cellSize);
+
+    Real   getCellSize     () const { return cellSize_; }
+    int    getCols         () const { return cols_; }
+    int    getRows         () const { return rows_; }
+    Real   getMaxHalfExtent() const { return maxHalfExtent_; }
+    size_t size            () const { return entries_.size(); }
+
+    int cellX(Real x) const { return std::clamp(static_cast<int>(std::floor((x - originX_) / cellSize_)), 0, std::max(0, cols_ - 1)); }
+    int cellY(Real y) const { return std::clamp(static_cast<int>(std::floor((y - originY_) / cellSize_)), 0, std::max(0, rows_ - 1)); }
+
+    template<typename Fn>
+    void forEachInCell(int cx, int cy, Fn fn) const {
+        size_t cell = static_cast<size_t>(cy) * cols_ + cx;
+        for (unsigned k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) {
+            fn(static_cast<size_t>(entries_[k]));
+        }
+    }
+
+    // Cells at Chebyshev distance `ring` from (cx, cy), clipped to the grid.
+    // Every molecule in ring r + 1 is at least r cells from any point in
+    // cell (cx, cy), which bounds nearest-neighbour searches.
+    template<typename Fn>
+    void forEachInRing(int cx, int cy, int ring, Fn fn) const {
+        if (ring == 0) {
+            forEachInCell(cx, cy, fn);
+            return;
+        }
+        int x0 = std::max(0, cx - ring), x1 = std::min(cols_ - 1, cx + ring);
+        int y0 = std::max(0, cy - ring), y1 = std::min(rows_ - 1, cy + ring);
+        if (cy - ring >= 0)    for (int x = x0; x <= x1; ++x) forEachInCell(x, cy - ring, fn);
+        if (cy + ring < rows_) for (int x = x0; x <= x1; ++x) forEachInCell(x, cy + ring, fn);
+        for (int y = std::max(y0, cy - ring + 1); y <= std::min(y1, cy + ring - 1); ++y) {
+            if (cx - ring >= 0)    forEachInCell(cx - ring, y, fn);
+            if (cx + ring < cols_) forEachInCell(cx + ring, y, fn);
+        }
+    }
+
+    // Rings beyond this one from (cx, cy) lie entirely outside the grid.
+    int maxRing(int cx, int cy) const {
+        return std::max(std::max(cx, cols_ - 1 - cx), std::max(cy, rows_ - 1 - cy));
+    }
+
+    // Calls fn(index) for every molecule in a cell touched by the rectangle,
+    // grown by the largest molecule half-size. Callers do the exact test.
+    template<typename Fn>
+    void forEachInRect(Real left, Real top, Real right, Real bottom, Fn fn) const {
+        if (cols_ == 0 || rows_ == 0 || right < left || bottom < top) return;
+
+        int x0 = cellX(left - maxHalfExtent_), x1 = cellX(right  + maxHalfExtent_);
+        int y0 = cellY(top  - maxHalfExtent_), y1 = cellY(bottom + maxHalfExtent_);
+
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                forEachInCell(cx, cy, fn);
+            }
+        }
+    }
+};
+
+#endif // SPATIAL_GRID_HPP
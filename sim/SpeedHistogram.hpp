@@ -0,0 +1,82 @@
+// SpeedHistogram.hpp
+#ifndef SPEED_HISTOGRAM_HPP
+#define SPEED_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Per-species speed distribution of the last step, filled by
+// Reactor::updateStatistics in the same pass as the energy sums.
+struct SpeedHistogram {
+    static const int SPECIES = 2;
+
+    int   bins     = 32;
+    float maxSpeed = 400.f;
+
+    std::vector<int> counts[SPECIES];
+    int   total     [SPECIES] = {0, 0};
+    float massSum   [SPECIES] = {0, 0};
+    float energySum [SPECIES] = {0, 0};
+
+    void configure(int binCount, float topSpeed) {
+        bins     = std::max(1, binCount);
+        maxSpeed = std::max(1e-3f, topSpeed);
+        clear();
+    }
+
+    void clear() {
+        for (int s = 0; s < SPECIES; ++s) {
+            counts[s].assign(bins, 0);
+            total[s] = 0;
+            massSum[s] = energySum[s] = 0;
+        }
+    }
+
+    void merge(const SpeedHistogram& other) {
+        for (int s = 0; s < SPECIES; ++s) {
+            for (int b = 0; b < bins; ++b) {
+                counts[s][b] += other.counts[s][b];
+            }
+            total[s]     += other.total[s];
+            massSum[s]   += other.massSum[s];
+            energySum[s] += other.energySum[s];
+        }
+    }
+
+    float binWidth() const { return maxSpeed / bins; }
+
+    // Speeds that are not finite (a blown-up step) are left out; the bin is
+    // clamped before the int conversion so huge ones cannot overflow it.
+    void add(int species, float speed, float mass, float energy) {
+        if (!std::isfinite(speed)) return;
+        float scaled = speed / binWidth();
+        int bin = scaled >= bins - 1 ? bins - 1 : static_cast<int>(std::max(0.f, scaled));
+        counts[species][bin]++;
+        total[species]++;
+        massSum[species]   += mass;
+        energySum[species] += energy;
+    }
+
+    // In 2D the mean kinetic energy per molecule equals kT.
+    float temperature(int species) const {
+        return total[species] > 0 ? energySum[species] / total[species] : 0;
+    }
+
+    // Expected count in `bin` for a 2D Maxwell-Boltzmann distribution with
+    // the species' mean mass and temperature: N * (F(v1) - F(v0)) where
+    // F(v) = 1 - exp(-m v^2 / 2kT). The last bin also takes the tail.
+    float expected(int species, int bin) const {
+        float kT = temperature(species);
+        if (kT <= 0 || total[species] == 0) return 0;
+
+        float m  = massSum[species] / total[species];
+        float v0 = bin * binWidth();
+        float v1 = (bin + 1) * binWidth();
+        float f0 = std::exp(-m * v0 * v0 / (2 * kT));
+        float f1 = bin == bins - 1 ? 0.f : std::exp(-m * v1 * v1 / (2 * kT));
+        return total[species] * (f0 - f1);
+    }
+};
+
+#endif // SPEED_HISTOGRAM_HPP
@@ -0,0 +1,485 @@
+// StatsArchive.cpp
+#include "StatsArchive.hpp"
+#include "Reactor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STATS_ARCHIVE_MMAP 1
+#endif
+
+using namespace StatsArchiveFormat;
+
+namespace {
+
+// A sample never needs more than this many bits (10-byte varints for the
+// step, 5-byte ones for counts, full-width XOR records for the floats).
+const size_t MAX_SAMPLE_BITS = 512;
+
+struct FileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t chunkSize;
+};
+
+std::uint64_t floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+std::uint64_t doubleBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+int countLeadingZeros(std::uint64_t value, int width) {
+    int count = 0;
+    for (std::uint64_t mask = std::uint64_t(1) << (width - 1); mask && !(value & mask); mask >>= 1) {
+        count++;
+    }
+    return count;
+}
+
+int countTrailingZeros(std::uint64_t value) {
+    int count = 0;
+    while (count < 64 && !(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+}
+
+class BitReader {
+private:
+    const std::uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+
+public:
+    struct FloatState {
+        std::uint64_t previous = 0;
+        int leading  = 0;
+        int trailing = 0;
+    };
+
+    BitReader(const std::uint8_t* data, size_t bits) : data_(data), size_(bits) {}
+
+    bool exhausted() const { return pos_ > size_; }
+
+    std::uint64_t readBits(int count) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < count; ++i, ++pos_) {
+            int bit = pos_ < size_ ? (data_[pos_ >> 3] >> (7 - (pos_ & 7))) & 1 : 0;
+            value = (value << 1) | bit;
+        }
+        return value;
+    }
+
+    std::uint64_t readVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint64_t byte = readBits(8);
+            value |= (byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        return value;
+    }
+
+    std::int64_t readSigned() {
+        std::uint64_t value = readVarint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    std::uint64_t readFloat(FloatState& state, int width) {
+        if (readBits(1) == 0) return state.previous;
+
+        if (readBits(1) == 1) {
+            state.leading = static_cast<int>(readBits(6));
+            int length    = static_cast<int>(readBits(6)) + 1;
+            state.trailing = width - state.leading - length;
+        }
+        int length = width - state.leading - state.trailing;
+        state.previous ^= readBits(length) << state.trailing;
+        return state.previous;
+    }
+};
+
+void decodeSamples(const std::uint8_t* payload, const ChunkHeader& header, std::vector<StatsSample>& out) {
+    BitReader reader(payload, header.payloadBits);
+    BitReader::FloatState time_state, energy_state, temperature_state;
+    StatsSample sample;
+
+    for (std::uint32_t i = 0; i < header.sampleCount && !reader.exhausted(); ++i) {
+        sample.step  += static_cast<std::uint64_t>(reader.readSigned());
+        std::uint64_t time = reader.readFloat(time_state, 64);
+        sample.total  += static_cast<int>(reader.readSigned());
+        sample.round  += static_cast<int>(reader.readSigned());
+        sample.square += static_cast<int>(reader.readSigned());
+        std::uint32_t energy      = static_cast<std::uint32_t>(reader.readFloat(energy_state,      32));
+        std::uint32_t temperature = static_cast<std::uint32_t>(reader.readFloat(temperature_state, 32));
+
+        std::memcpy(&sample.time,        &time,        sizeof(sample.time));
+        std::memcpy(&sample.energy,      &energy,      sizeof(sample.energy));
+        std::memcpy(&sample.temperature, &temperature, sizeof(sample.temperature));
+        out.push_back(sample);
+    }
+}
+
+}
+
+StatsSample StatsSample::fromReactor(const Reactor& reactor) {
+    StatsSample sample;
+    sample.step = static_cast<std::uint64_t>(reactor.getStepCount());
+    sample.time = reactor.getSimTime();
+    if (!reactor.getMoleculeHistory().empty()) {
+        sample.total       = reactor.getMoleculeHistory      ().back();
+        sample.round       = reactor.getRoundMoleculeHistory ().back();
+        sample.square      = reactor.getSquareMoleculeHistory().back();
+        sample.energy      = reactor.getEnergyHistory        ().back();
+        sample.temperature = reactor.getTemperatureHistory   ().back();
+    }
+    return sample;
+}
+
+StatsArchiveWriter::~StatsArchiveWriter() {
+    close();
+}
+
+bool StatsArchiveWriter::open(const std::string& path) {
+    close();
+
+    file_.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!file_) return false;
+
+    path_ = path;
+    chunk_index_ = 0;
+    samples_ = 0;
+    written_.clear();
+
+    std::vector<char> page(HEADER_SIZE, 0);
+    FileHeader header = {MAGIC, VERSION, static_cast<std::uint32_t>(HEADER_SIZE), static_cast<std::uint32_t>(CHUNK_SIZE)};
+    std::memcpy(page.data(), &header, sizeof(header));
+    file_.write(page.data(), page.size());
+
+    payload_.assign(PAYLOAD_SIZE, 0);
+    startChunk();
+    return static_cast<bool>(file_);
+}
+
+void StatsArchiveWriter::close() {
+    if (!file_.is_open()) return;
+    flush();
+    file_.close();
+}
+
+void StatsArchiveWriter::startChunk() {
+    header_ = ChunkHeader{};
+    header_.magic = CHUNK_MAGIC;
+    std::fill(payload_.begin(), payload_.end(), 0);
+    bits_ = 0;
+    chunk_dirty_ = false;
+
+    // Each chunk decodes on its own: deltas restart from a zero sample.
+    previous_ = StatsSample();
+    time_state_ = energy_state_ = temperature_state_ = FloatState();
+}
+
+void StatsArchiveWriter::writeChunk() {
+    size_t offset = HEADER_SIZE + chunk_index_ * CHUNK_SIZE;
+
+    // Payload before header: a reader mapping the file mid-write sees the
+    // old sample count over bits that only ever get appended to.
+    file_.seekp(offset + sizeof(ChunkHeader));
+    file_.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+    file_.seekp(offset);
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    file_.flush();
+    chunk_dirty_ = false;
+}
+
+void StatsArchiveWriter::flush() {
+    if (file_.is_open() && chunk_dirty_) {
+        writeChunk();
+    }
+}
+
+void StatsArchiveWriter::writeBits(std::uint64_t value, int count) {
+    for (int i = count - 1; i >= 0; --i, ++bits_) {
+        if ((value >> i) & 1) {
+            payload_[bits_ >> 3] |= static_cast<std::uint8_t>(0x80 >> (bits_ & 7));
+        }
+    }
+}
+
+void StatsArchiveWriter::writeVarint(std::uint64_t value) {
+    do {
+        std::uint64_t byte = value & 0x7f;
+        value >>= 7;
+        writeBits(value ? byte | 0x80 : byte, 8);
+    } while (value);
+}
+
+void StatsArchiveWriter::writeSigned(std::int64_t value) {
+    writeVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void StatsArchiveWriter::writeFloat(FloatState& state, std::uint64_t bits, int width) {
+    std::uint64_t diff = bits ^ state.previous;
+    state.previous = bits;
+
+    if (diff == 0) {
+        writeBits(0, 1);
+        return;
+    }
+    writeBits(1, 1);
+
+    int leading  = countLeadingZeros(diff, width);
+    int trailing = countTrailingZeros(diff);
+    if (state.leading >= 0 && leading >= state.leading && trailing >= state.trailing) {
+        writeBits(0, 1);
+        writeBits(diff >> state.trailing, width - state.leading - state.trailing);
+        return;
+    }
+
+    int length = width - leading - trailing;
+    writeBits(1, 1);
+    writeBits(leading, 6);
+    writeBits(length - 1, 6);
+    writeBits(diff >> trailing, length);
+    state.leading  = leading;
+    state.trailing = trailing;
+}
+
+void StatsArchiveWriter::append(const StatsSample& sample) {
+    if (!file_.is_open()) return;
+
+    if (header_.sampleCount > 0 && sample.step <= header_.lastStep) {
+        truncateFrom(sample.step);
+    }
+
+    if (bits_ + MAX_SAMPLE_BITS > PAYLOAD_SIZE * 8) {
+        writeChunk();
+        written_.push_back(header_);
+        chunk_index_++;
+        startChunk();
+    }
+
+    if (header_.sampleCount == 0) {
+        header_.firstStep = sample.step;
+        header_.firstTime = sample.time;
+    }
+
+    writeSigned(static_cast<std::int64_t>(sample.step - previous_.step));
+    writeFloat (time_state_, doubleBits(sample.time), 64);
+    writeSigned(static_cast<std::int64_t>(sample.total)  - previous_.total);
+    writeSigned(static_cast<std::int64_t>(sample.round)  - previous_.round);
+    writeSigned(static_cast<std::int64_t>(sample.square) - previous_.square);
+    writeFloat (energy_state_,      floatBits(sample.energy),      32);
+    writeFloat (temperature_state_, floatBits(sample.temperature), 32);
+
+    float values[FIELDS] = {static_cast<float>(sample.total), static_cast<float>(sample.round),
+                            static_cast<float>(sample.square), sample.energy, sample.temperature};
+    for (int k = 0; k < FIELDS; ++k) {
+        header_.minValue[k] = header_.sampleCount ? std::min(header_.minValue[k], values[k]) : values[k];
+        header_.maxValue[k] = header_.sampleCount ? std::max(header_.maxValue[k], values[k]) : values[k];
+        header_.sumValue[k] += values[k];
+    }
+
+    previous_ = sample;
+    header_.sampleCount++;
+    header_.payloadBits = static_cast<std::uint32_t>(bits_);
+    header_.lastStep = sample.step;
+    header_.lastTime = sample.time;
+    chunk_dirty_ = true;
+    samples_++;
+}
+
+void StatsArchiveWriter::truncateFrom(std::uint64_t step) {
+    // The newest chunk that keeps any samples; the ones after it are
+    // blanked so readers stop in front of them.
+    size_t index = chunk_index_;
+    auto firstStep = [this](size_t i) { return i < written_.size() ? written_[i].firstStep : header_.firstStep; };
+    while (index > 0 && firstStep(index) >= step) {
+        index--;
+    }
+
+    std::vector<StatsSample> kept;
+    if (index < chunk_index_) {
+        file_.seekg(HEADER_SIZE + index * CHUNK_SIZE + sizeof(ChunkHeader));
+        file_.read(reinterpret_cast<char*>(payload_.data()), payload_.size());
+        decodeSamples(payload_.data(), written_[index], kept);
+
+        ChunkHeader blank{};
+        for (size_t i = index + 1; i <= chunk_index_; ++i) {
+            file_.seekp(HEADER_SIZE + i * CHUNK_SIZE);
+            file_.write(reinterpret_cast<const char*>(&blank), sizeof(blank));
+        }
+    } else {
+        decodeSamples(payload_.data(), header_, kept);
+    }
+    kept.erase(std::find_if(kept.begin(), kept.end(), [step](const StatsSample& s) { return s.step >= step; }),
+               kept.end());
+
+    written_.resize(index);
+    chunk_index_ = index;
+    samples_ = 0;
+    for (const ChunkHeader& header : written_) {
+        samples_ += header.sampleCount;
+    }
+
+    // Re-encoding from the chunk start reproduces the same bits.
+    startChunk();
+    for (const StatsSample& sample : kept) {
+        append(sample);
+    }
+    writeChunk();
+}
+
+StatsArchiveReader::~StatsArchiveReader() {
+    close();
+}
+
+bool StatsArchiveReader::open(const std::string& path) {
+    close();
+    path_ = path;
+
+#ifdef STATS_ARCHIVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (address != MAP_FAILED) {
+            data_ = static_cast<const std::uint8_t*>(address);
+            size_ = static_cast<size_t>(info.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (!copy_.empty()) {
+        data_ = copy_.data();
+        size_ = copy_.size();
+    }
+#endif
+
+    FileHeader header;
+    if (!data_ || size_ < HEADER_SIZE) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.headerSize != HEADER_SIZE || header.chunkSize != CHUNK_SIZE) {
+        close();
+        return false;
+    }
+
+    for (size_t offset = HEADER_SIZE; offset + CHUNK_SIZE <= size_; offset += CHUNK_SIZE) {
+        ChunkInfo chunk;
+        chunk.data = data_ + offset;
+        std::memcpy(&chunk.header, chunk.data, sizeof(ChunkHeader));
+        if (chunk.header.magic != CHUNK_MAGIC || chunk.header.sampleCount == 0 ||
+            chunk.header.payloadBits > PAYLOAD_SIZE * 8) {
+            break;
+        }
+        chunks_.push_back(chunk);
+        samples_ += chunk.header.sampleCount;
+    }
+    return true;
+}
+
+bool StatsArchiveReader::refresh() {
+    std::string path = path_;
+    return open(path);
+}
+
+void StatsArchiveReader::unmap() {
+#ifdef STATS_ARCHIVE_MMAP
+    if (mapped_) {
+        munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif
+    mapped_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    copy_.clear();
+}
+
+void StatsArchiveReader::close() {
+    unmap();
+    chunks_.clear();
+    samples_ = 0;
+}
+
+double StatsArchiveReader::getFirstTime() const {
+    return chunks_.empty() ? 0 : chunks_.front().header.firstTime;
+}
+
+double StatsArchiveReader::getLastTime() const {
+    return chunks_.empty() ? 0 : chunks_.back().header.lastTime;
+}
+
+void StatsArchiveReader::decodeChunk(const ChunkInfo& chunk, std::vector<StatsSample>& out) const {
+    decodeSamples(chunk.data + sizeof(ChunkHeader), chunk.header, out);
+}
+
+void StatsArchiveReader::readRange(double from, double to, bool bySteps,
+                                   std::vector<StatsSample>& out, size_t maxSamples) const {
+    auto chunkFirst = [bySteps](const ChunkInfo& c) { return bySteps ? static_cast<double>(c.header.firstStep) : c.header.firstTime; };
+    auto chunkLast  = [bySteps](const ChunkInfo& c) { return bySteps ? static_cast<double>(c.header.lastStep)  : c.header.lastTime; };
+    auto key        = [bySteps](const StatsSample& s) { return bySteps ? static_cast<double>(s.step) : s.time; };
+
+    auto begin = std::lower_bound(chunks_.begin(), chunks_.end(), from,
+                                  [&](const ChunkInfo& c, double value) { return chunkLast(c) < value; });
+    auto end = begin;
+    size_t estimate = 0;
+    while (end != chunks_.end() && chunkFirst(*end) <= to) {
+        estimate += end->header.sampleCount;
+        ++end;
+    }
+
+    size_t stride = (maxSamples > 0 && estimate > maxSamples) ? (estimate + maxSamples - 1) / maxSamples : 1;
+    size_t seen = 0;
+    std::vector<StatsSample> scratch;
+    for (auto it = begin; it != end; ++it) {
+        scratch.clear();
+        decodeChunk(*it, scratch);
+        for (const StatsSample& sample : scratch) {
+            double k = key(sample);
+            if (k < from || k > to) continue;
+            if (seen++ % stride == 0) {
+                out.push_back(sample);
+            }
+        }
+    }
+}
+
+void StatsArchiveReader::readChunkSummaries(double from, double to, std::vector<ChunkHeader>& out) const {
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), from,
+                               [](const ChunkInfo& c, double value) { return c.header.lastTime < value; });
+    for (; it != chunks_.end() && it->header.firstTime <= to; ++it) {
+        out.push_back(it->header);
+    }
+}
+
+void StatsArchiveReader::readTimeRange(double from, double to, std::vector<StatsSample>& out, size_t maxSamples) const {
+    readRange(from, to, false, out, maxSamples);
+}
+
+void StatsArchiveReader::readStepRange(std::uint64_t from, std::uint64_t to, std::vector<StatsSample>& out, size_t maxSamples) const {
+    readRange(static_cast<double>(from), static_cast<double>(to), true, out, maxSamples);
+}
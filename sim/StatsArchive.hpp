@@ -0,0 +1,164 @@
+// StatsArchive.hpp
+#ifndef STATS_ARCHIVE_HPP
+#define STATS_ARCHIVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Reactor;
+
+struct StatsSample {
+    std::uint64_t step        = 0;
+    double        time        = 0;
+    int           total       = 0;
+    int           round       = 0;
+    int           square      = 0;
+    float         energy      = 0;
+    float         temperature = 0;
+
+    // The sample for the step the reactor has just finished.
+    static StatsSample fromReactor(const Reactor& reactor);
+};
+
+// On-disk layout: one HEADER_SIZE page, then CHUNK_SIZE chunks, so every
+// chunk is page aligned and the file can be mapped and read in place.
+// Inside a chunk, steps and counts are zigzag deltas in varints and the
+// floating point fields are XORed with their previous value and stored as
+// the meaningful bits only (Gorilla style). Values are little endian.
+//
+// Each chunk header also sums up its samples (minimum, maximum and sum of
+// total, round, square, energy and temperature, in that order), so long
+// ranges can be drawn from the headers without decoding.
+namespace StatsArchiveFormat {
+    const std::uint32_t MAGIC       = 0x31415352; // "RSA1"
+    const std::uint32_t CHUNK_MAGIC = 0x4b4e4843; // "CHNK"
+    const std::uint32_t VERSION     = 2;
+    const size_t        HEADER_SIZE = 4096;
+    const size_t        CHUNK_SIZE  = 64 * 1024;
+    const int           FIELDS      = 5;
+
+    struct ChunkHeader {
+        std::uint32_t magic;
+        std::uint32_t sampleCount;
+        std::uint32_t payloadBits;
+        std::uint32_t reserved;
+        std::uint64_t firstStep;
+        std::uint64_t lastStep;
+        double        firstTime;
+        double        lastTime;
+        double        sumValue[FIELDS];
+        float         minValue[FIELDS];
+        float         maxValue[FIELDS];
+    };
+
+    const size_t PAYLOAD_SIZE = CHUNK_SIZE - sizeof(ChunkHeader);
+}
+
+// Append-only writer. Samples go to the open chunk in memory; a full chunk
+// is written out and a new one started. flush() also writes the open chunk
+// so readers see the newest samples.
+//
+// A sample whose step does not follow the last one (the reactor was
+// rewound) first cuts the archive back to the steps before it, so steps
+// and times stay increasing. Readers opened before that need refresh().
+class StatsArchiveWriter {
+private:
+    struct FloatState {
+        std::uint64_t previous = 0;
+        int leading  = -1;
+        int trailing = 0;
+    };
+
+    std::fstream  file_;
+    std::string   path_;
+    size_t        chunk_index_ = 0;
+    bool          chunk_dirty_ = false;
+    std::uint64_t samples_     = 0;
+
+    std::vector<StatsArchiveFormat::ChunkHeader> written_;   // chunks before chunk_index_
+
+    StatsArchiveFormat::ChunkHeader header_{};
+    std::vector<std::uint8_t>       payload_;
+    size_t                          bits_ = 0;
+
+    StatsSample previous_;
+    FloatState  time_state_, energy_state_, temperature_state_;
+
+    void writeBits  (std::uint64_t value, int count);
+    void writeVarint(std::uint64_t value);
+    void writeSigned(std::int64_t  value);
+    void writeFloat (FloatState& state, std::uint64_t bits, int width);
+    void startChunk ();
+    void writeChunk ();
+    void truncateFrom(std::uint64_t step);
+
+public:
+    StatsArchiveWriter() = default;
+    ~StatsArchiveWriter();
+    StatsArchiveWriter(const StatsArchiveWriter&) = delete;
+    StatsArchiveWriter& operator=(const StatsArchiveWriter&) = delete;
+
+    // Creates (truncates) the archive at `path`.
+    bool open (const std::string& path);
+    void close();
+    bool isOpen() const { return file_.is_open(); }
+
+    void append(const StatsSample& sample);
+    void flush ();
+
+    const std::string& getPath       () const { return path_; }
+    std::uint64_t      getSampleCount() const { return samples_; }
+};
+
+// Maps an archive (a copy of it where mmap is unavailable) and decodes
+// time or step ranges. Only the chunks overlapping the range are decoded.
+class StatsArchiveReader {
+private:
+    struct ChunkInfo {
+        const std::uint8_t*             data;
+        StatsArchiveFormat::ChunkHeader header;
+    };
+
+    std::string               path_;
+    const std::uint8_t*       data_ = nullptr;
+    size_t                    size_ = 0;
+    bool                      mapped_ = false;
+    std::vector<std::uint8_t> copy_;
+    std::vector<ChunkInfo>    chunks_;
+    std::uint64_t             samples_ = 0;
+
+    void unmap();
+    void decodeChunk(const ChunkInfo& chunk, std::vector<StatsSample>& out) const;
+    void readRange  (double from, double to, bool bySteps,
+                     std::vector<StatsSample>& out, size_t maxSamples) const;
+
+public:
+    StatsArchiveReader() = default;
+    ~StatsArchiveReader();
+    StatsArchiveReader(const StatsArchiveReader&) = delete;
+    StatsArchiveReader& operator=(const StatsArchiveReader&) = delete;
+
+    bool open (const std::string& path);
+    // Remaps the file to pick up samples flushed since open().
+    bool refresh();
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    std::uint64_t getSampleCount() const { return samples_; }
+    size_t        getChunkCount () const { return chunks_.size(); }
+    double        getFirstTime  () const;
+    double        getLastTime   () const;
+
+    // Appends the samples with from <= time <= to. With maxSamples > 0 the
+    // range is thinned to at most that many evenly spaced samples.
+    void readTimeRange(double from, double to, std::vector<StatsSample>& out, size_t maxSamples = 0) const;
+    void readStepRange(std::uint64_t from, std::uint64_t to, std::vector<StatsSample>& out, size_t maxSamples = 0) const;
+    // Appends the headers of the chunks overlapping [from, to] seconds.
+    // Nothing is decoded, so this costs O(log chunks + result).
+    void readChunkSummaries(double from, double to, std::vector<StatsArchiveFormat::ChunkHeader>& out) const;
+};
+
+#endif // STATS_ARCHIVE_HPP
@@ -0,0 +1,214 @@
+// Trajectory.cpp
+#include "Trajectory.hpp"
+#include <algorithm>
+
+using namespace TrajectoryFormat;
+
+namespace {
+
+class PayloadReader {
+private:
+    const std::uint8_t* pos_;
+    const std::uint8_t* end_;
+    bool ok_ = true;
+
+public:
+    PayloadReader(const std::uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+
+    std::uint8_t readByte() {
+        if (pos_ == end_) {
+            ok_ = false;
+            return 0;
+        }
+        return *pos_++;
+    }
+
+    std::uint64_t readVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint64_t byte = readByte();
+            value |= (byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        return value;
+    }
+
+    std::int64_t readSigned() {
+        std::uint64_t value = readVarint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // `count` entries of id gap, type, qx, qy.
+    void readEntries(size_t count, std::vector<TrajectoryState>& out) {
+        out.clear();
+        std::uint32_t id = 0;
+        for (size_t i = 0; i < count && ok_; ++i) {
+            TrajectoryState state;
+            id        += static_cast<std::uint32_t>(readVarint());
+            state.id   = id;
+            state.type = readByte();
+            state.qx   = static_cast<std::int32_t>(readVarint());
+            state.qy   = static_cast<std::int32_t>(readVarint());
+            state.dx   = 0;
+            state.dy   = 0;
+            out.push_back(state);
+        }
+    }
+};
+
+bool byId(const TrajectoryState& a, const TrajectoryState& b) {
+    return a.id < b.id;
+}
+
+}
+
+size_t TrajectoryFrame::find(std::uint32_t id) const {
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    return it != ids.end() && *it == id ? static_cast<size_t>(it - ids.begin()) : ids.size();
+}
+
+bool TrajectoryReader::open(const std::string& path) {
+    close();
+    file_.open(path, std::ios::binary);
+    if (!file_) return false;
+
+    file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+    if (file_.gcount() != sizeof(header_) || header_.magic != MAGIC || header_.version != VERSION ||
+        header_.headerSize < sizeof(header_) || header_.quantBits < 1 || header_.quantBits > 30) {
+        close();
+        return false;
+    }
+    file_.seekg(header_.headerSize);
+    return true;
+}
+
+void TrajectoryReader::close() {
+    if (file_.is_open()) file_.close();
+    file_.clear();
+    header_ = TrajectoryFileHeader{};
+    state_.clear();
+    synced_ = false;
+}
+
+bool TrajectoryReader::readFrameHeader(TrajectoryFrameHeader& frame) {
+    file_.read(reinterpret_cast<char*>(&frame), sizeof(frame));
+    return file_.gcount() == sizeof(frame) && frame.magic == FRAME_MAGIC;
+}
+
+bool TrajectoryReader::next(TrajectoryFrame& frame) {
+    if (!isOpen()) return false;
+
+    TrajectoryFrameHeader header;
+    if (!readFrameHeader(header)) return false;
+    payload_.resize(header.payloadSize);
+    file_.read(reinterpret_cast<char*>(payload_.data()), header.payloadSize);
+    if (static_cast<size_t>(file_.gcount()) != header.payloadSize) return false;
+
+    bool keyframe = (header.flags & KEYFRAME) != 0;
+    if (!keyframe && !synced_) return false;
+    synced_ = false;
+
+    PayloadReader in(payload_.data(), payload_.size());
+    frame.removed.clear();
+    frame.spawned.clear();
+
+    if (keyframe) {
+        in.readEntries(header.count, state_);
+    } else {
+        std::uint32_t id = 0;
+        for (std::uint32_t k = 0; k < header.removed; ++k) {
+            id += static_cast<std::uint32_t>(in.readVarint());
+            frame.removed.push_back(id);
+        }
+
+        // Survivors come in id order with the removed ones left out.
+        size_t kept = 0, r = 0;
+        for (size_t i = 0; i < state_.size(); ++i) {
+            TrajectoryState state = state_[i];
+            if (r < frame.removed.size() && frame.removed[r] == state.id) {
+                ++r;
+                continue;
+            }
+            state.dx += static_cast<std::int32_t>(in.readSigned());
+            state.dy += static_cast<std::int32_t>(in.readSigned());
+            state.qx += state.dx;
+            state.qy += state.dy;
+            state_[kept++] = state;
+        }
+        if (r != frame.removed.size()) return false;
+        state_.resize(kept);
+
+        in.readEntries(header.spawned, spawned_);
+        for (const TrajectoryState& state : spawned_) {
+            frame.spawned.push_back(state.id);
+        }
+        state_.insert(state_.end(), spawned_.begin(), spawned_.end());
+        std::inplace_merge(state_.begin(), state_.begin() + kept, state_.end(), byId);
+    }
+    if (!in.ok() || state_.size() != header.count) return false;
+    synced_ = true;
+
+    frame.step         = header.step;
+    frame.simTime      = header.simTime;
+    frame.keyframe     = keyframe;
+    frame.boundsX      = header.boundsX;
+    frame.boundsY      = header.boundsY;
+    frame.boundsWidth  = header.boundsWidth;
+    frame.boundsHeight = header.boundsHeight;
+
+    float scaleX = header.boundsWidth  / static_cast<float>((1u << header_.quantBits) - 1);
+    float scaleY = header.boundsHeight / static_cast<float>((1u << header_.quantBits) - 1);
+    size_t count = state_.size();
+    frame.ids  .resize(count);
+    frame.types.resize(count);
+    frame.x    .resize(count);
+    frame.y    .resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const TrajectoryState& state = state_[i];
+        frame.ids[i]   = state.id;
+        frame.types[i] = state.type;
+        frame.x[i]     = header.boundsX + state.qx * scaleX;
+        frame.y[i]     = header.boundsY + state.qy * scaleY;
+    }
+    return true;
+}
+
+bool TrajectoryReader::seek(std::uint64_t step) {
+    if (!isOpen()) return false;
+
+    file_.clear();
+    file_.seekg(header_.headerSize);
+
+    // A step that does not follow the previous frame's starts a new run
+    // (the writer rewound); only keyframes of the current run can lead to
+    // `step` through its deltas.
+    std::streamoff best = -1, fallback = -1, candidate = -1;
+    std::uint64_t last = 0;
+    bool first = true;
+    TrajectoryFrameHeader header;
+    for (;;) {
+        std::streamoff position = file_.tellg();
+        if (!readFrameHeader(header)) break;
+        if (!first && header.step <= last) candidate = -1;
+        if ((header.flags & KEYFRAME) && header.step <= step) {
+            candidate = position;
+            fallback  = position;
+        }
+        if (candidate >= 0 && header.step >= step) best = candidate;
+        last  = header.step;
+        first = false;
+        file_.seekg(header.payloadSize, std::ios::cur);
+    }
+    if (best < 0) best = fallback;
+
+    file_.clear();
+    synced_ = false;
+    if (best < 0) {
+        file_.seekg(header_.headerSize);
+        return false;
+    }
+    file_.seekg(best);
+    return true;
+}
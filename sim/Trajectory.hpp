@@ -0,0 +1,118 @@
+// Trajectory.hpp
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Layout of a trajectory file written by TrajectoryWriter: a
+// TrajectoryFileHeader, then one TrajectoryFrameHeader plus payload per
+// sampled step. Values are little endian.
+//
+// Positions are quantised to `quantBits` bits across the reactor bounds of
+// their frame. Molecules are listed in id order. A keyframe payload holds,
+// per molecule: varint id gap, type byte, varint qx, varint qy. A delta
+// payload holds three parts:
+//   removed    `removed` varint id gaps
+//   survivors  per molecule still present, zigzag varints of qx and qy
+//              minus the prediction (its previous position plus its
+//              previous move)
+//   spawned    `spawned` entries laid out as in a keyframe
+// The id gaps start from 0 in each list.
+namespace TrajectoryFormat {
+    const std::uint32_t MAGIC       = 0x314a5452; // "RTJ1"
+    const std::uint32_t FRAME_MAGIC = 0x4d415246; // "FRAM"
+    const std::uint32_t VERSION     = 1;
+
+    enum FrameFlags : std::uint32_t {
+        KEYFRAME = 1
+    };
+}
+
+struct TrajectoryFileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t quantBits;
+    std::uint32_t sampleInterval;
+    std::uint32_t keyframeInterval;
+};
+
+struct TrajectoryFrameHeader {
+    std::uint32_t magic;
+    std::uint32_t flags;
+    std::uint32_t payloadSize;
+    std::uint32_t count;
+    std::uint32_t spawned;
+    std::uint32_t removed;
+    std::uint64_t step;
+    double        simTime;
+    float         boundsX, boundsY, boundsWidth, boundsHeight;
+};
+
+// Quantised state of one molecule, shared by the encoder and the decoder.
+struct TrajectoryState {
+    std::uint32_t id;
+    std::uint8_t  type;
+    std::int32_t  qx, qy;
+    std::int32_t  dx, dy;   // move since the previous frame
+};
+
+// One decoded frame; molecules are sorted by id.
+struct TrajectoryFrame {
+    std::uint64_t step     = 0;
+    double        simTime  = 0;
+    bool          keyframe = false;
+    float         boundsX = 0, boundsY = 0, boundsWidth = 0, boundsHeight = 0;
+
+    std::vector<std::uint32_t> ids;
+    std::vector<std::uint8_t>  types;   // 0 round, 1 square
+    std::vector<float>         x, y;
+    // Molecules that appeared or vanished since the previous frame; empty
+    // for keyframes.
+    std::vector<std::uint32_t> spawned;
+    std::vector<std::uint32_t> removed;
+
+    size_t size() const { return ids.size(); }
+    // Index of the molecule with that id, or size() when absent.
+    size_t find(std::uint32_t id) const;
+};
+
+// Streams frames out of a trajectory file in order, one at a time.
+class TrajectoryReader {
+private:
+    std::ifstream                file_;
+    TrajectoryFileHeader         header_{};
+    std::vector<std::uint8_t>    payload_;
+    std::vector<TrajectoryState> state_;
+    std::vector<TrajectoryState> spawned_;
+    bool                         synced_ = false;   // state_ matches the last frame read
+
+    bool readFrameHeader(TrajectoryFrameHeader& frame);
+
+public:
+    TrajectoryReader() = default;
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    bool open (const std::string& path);
+    void close();
+    bool isOpen() const { return file_.is_open(); }
+
+    // False at the end of the file or at a damaged or cut-off frame.
+    bool next(TrajectoryFrame& frame);
+    // Moves to the last keyframe at or before `step`, so the following
+    // next() returns it. Scans every frame header: after a rewind the file
+    // holds the same steps more than once, and the newest run that reaches
+    // `step` wins (the newest keyframe before it if none does).
+    bool seek(std::uint64_t step);
+
+    std::uint32_t getQuantBits       () const { return header_.quantBits; }
+    std::uint32_t getSampleInterval  () const { return header_.sampleInterval; }
+    std::uint32_t getKeyframeInterval() const { return header_.keyframeInterval; }
+};
+
+#endif // TRAJECTORY_HPP
@@ -0,0 +1,245 @@
+// TrajectoryWriter.cpp
+#include "TrajectoryWriter.hpp"
+#include "Reactor.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace TrajectoryFormat;
+
+namespace {
+
+void writeVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void writeSigned(std::vector<std::uint8_t>& out, std::int64_t value) {
+    writeVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void writeEntry(std::vector<std::uint8_t>& out, const TrajectoryState& state, std::uint32_t& lastId) {
+    writeVarint(out, state.id - lastId);
+    out.push_back(state.type);
+    writeVarint(out, static_cast<std::uint32_t>(state.qx));
+    writeVarint(out, static_cast<std::uint32_t>(state.qy));
+    lastId = state.id;
+}
+
+std::int32_t quantise(float value, float origin, float extent, float steps) {
+    float scaled = extent > 0 ? (value - origin) / extent * steps : 0;
+    return static_cast<std::int32_t>(std::lround(std::clamp(scaled, 0.f, steps)));
+}
+
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string& path, const TrajectoryOptions& options) {
+    close();
+
+    options_ = options;
+    options_.quantBits        = std::clamp(options_.quantBits, 1u, 30u);
+    options_.sampleInterval   = std::max(options_.sampleInterval, 1u);
+    options_.keyframeInterval = std::max(options_.keyframeInterval, 1u);
+    options_.maxPending       = std::max<size_t>(options_.maxPending, 1);
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) return false;
+    path_ = path;
+
+    TrajectoryFileHeader header{};
+    header.magic            = MAGIC;
+    header.version          = VERSION;
+    header.headerSize       = sizeof(TrajectoryFileHeader);
+    header.quantBits        = options_.quantBits;
+    header.sampleInterval   = options_.sampleInterval;
+    header.keyframeInterval = options_.keyframeInterval;
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    frames_ = 0;
+    bytes_  = sizeof(header);
+    stalls_ = 0;
+    previous_.clear();
+    since_keyframe_ = 0;
+    stop_ = false;
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void TrajectoryWriter::close() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_cv_.notify_all();
+        thread_.join();
+    }
+    if (file_.is_open()) {
+        file_.close();
+    }
+    queue_.clear();
+    free_.clear();
+    allocated_ = 0;
+}
+
+void TrajectoryWriter::record(const Reactor& reactor) {
+    if (!isOpen() || reactor.getStepCount() % options_.sampleInterval != 0) return;
+
+    std::unique_ptr<Snapshot> snapshot;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (free_.empty() && allocated_ >= options_.maxPending) {
+            stalls_++;
+            free_cv_.wait(lock, [this]() { return !free_.empty(); });
+        }
+        if (free_.empty()) {
+            allocated_++;
+            snapshot = std::make_unique<Snapshot>();
+        } else {
+            snapshot = std::move(free_.back());
+            free_.pop_back();
+        }
+    }
+
+    snapshot->step         = static_cast<std::uint64_t>(reactor.getStepCount());
+    snapshot->simTime      = reactor.getSimTime();
+    snapshot->boundsX      = static_cast<float>(reactor.getReactorX());
+    snapshot->boundsY      = static_cast<float>(reactor.getReactorY());
+    snapshot->boundsWidth  = static_cast<float>(reactor.getReactorWidth());
+    snapshot->boundsHeight = static_cast<float>(reactor.getReactorHeight());
+
+    const auto& molecules = reactor.getMolecules();
+    snapshot->molecules.resize(molecules.size());
+    for (size_t i = 0; i < molecules.size(); ++i) {
+        const Molecule& mol = *molecules[i];
+        Snapshot::Entry& entry = snapshot->molecules[i];
+        entry.id   = mol.getId();
+        entry.type = static_cast<std::uint8_t>(mol.getType());
+        entry.x    = static_cast<float>(mol.getPosition().x);
+        entry.y    = static_cast<float>(mol.getPosition().y);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(snapshot));
+    }
+    ready_cv_.notify_one();
+}
+
+void TrajectoryWriter::run() {
+    for (;;) {
+        std::unique_ptr<Snapshot> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) break;
+            snapshot = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        encode(*snapshot);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(std::move(snapshot));
+        }
+        free_cv_.notify_one();
+    }
+    file_.flush();
+}
+
+void TrajectoryWriter::encode(Snapshot& snapshot) {
+    // Ids only fall out of order after a reorder; most frames skip the sort.
+    auto& molecules = snapshot.molecules;
+    auto byId = [](const Snapshot::Entry& a, const Snapshot::Entry& b) { return a.id < b.id; };
+    if (!std::is_sorted(molecules.begin(), molecules.end(), byId)) {
+        std::sort(molecules.begin(), molecules.end(), byId);
+    }
+
+    float steps = static_cast<float>((1u << options_.quantBits) - 1);
+    current_.resize(molecules.size());
+    for (size_t i = 0; i < molecules.size(); ++i) {
+        TrajectoryState& state = current_[i];
+        state.id   = molecules[i].id;
+        state.type = molecules[i].type;
+        state.qx   = quantise(molecules[i].x, snapshot.boundsX, snapshot.boundsWidth,  steps);
+        state.qy   = quantise(molecules[i].y, snapshot.boundsY, snapshot.boundsHeight, steps);
+        state.dx   = 0;
+        state.dy   = 0;
+    }
+
+    bool keyframe = frames_ == 0 || since_keyframe_ + 1 >= options_.keyframeInterval ||
+                    snapshot.step <= last_step_;
+    payload_.clear();
+    removed_.clear();
+    spawned_.clear();
+
+    if (keyframe) {
+        std::uint32_t lastId = 0;
+        for (const TrajectoryState& state : current_) {
+            writeEntry(payload_, state, lastId);
+        }
+        since_keyframe_ = 0;
+    } else {
+        // Pair both frames up by id. The removed list goes first in the
+        // payload, so the survivors are coded into their own buffer.
+        survivors_.clear();
+        size_t i = 0, j = 0;
+        while (i < previous_.size() || j < current_.size()) {
+            if (j == current_.size() || (i < previous_.size() && previous_[i].id < current_[j].id)) {
+                removed_.push_back(previous_[i++].id);
+            } else if (i == previous_.size() || previous_[i].id > current_[j].id) {
+                spawned_.push_back(j++);
+            } else if (previous_[i].type != current_[j].type) {
+                removed_.push_back(previous_[i++].id);
+                spawned_.push_back(j++);
+            } else {
+                const TrajectoryState& before = previous_[i++];
+                TrajectoryState& now = current_[j++];
+                now.dx = now.qx - before.qx;
+                now.dy = now.qy - before.qy;
+                writeSigned(survivors_, now.dx - before.dx);
+                writeSigned(survivors_, now.dy - before.dy);
+            }
+        }
+
+        std::uint32_t lastId = 0;
+        for (std::uint32_t id : removed_) {
+            writeVarint(payload_, id - lastId);
+            lastId = id;
+        }
+        payload_.insert(payload_.end(), survivors_.begin(), survivors_.end());
+        lastId = 0;
+        for (size_t index : spawned_) {
+            writeEntry(payload_, current_[index], lastId);
+        }
+        since_keyframe_++;
+    }
+
+    TrajectoryFrameHeader header{};
+    header.magic        = FRAME_MAGIC;
+    header.flags        = keyframe ? static_cast<std::uint32_t>(KEYFRAME) : 0u;
+    header.payloadSize  = static_cast<std::uint32_t>(payload_.size());
+    header.count        = static_cast<std::uint32_t>(current_.size());
+    header.spawned      = static_cast<std::uint32_t>(spawned_.size());
+    header.removed      = static_cast<std::uint32_t>(removed_.size());
+    header.step         = snapshot.step;
+    header.simTime      = snapshot.simTime;
+    header.boundsX      = snapshot.boundsX;
+    header.boundsY      = snapshot.boundsY;
+    header.boundsWidth  = snapshot.boundsWidth;
+    header.boundsHeight = snapshot.boundsHeight;
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.write(reinterpret_cast<const char*>(payload_.data()), static_cast<std::streamsize>(payload_.size()));
+
+    previous_.swap(current_);
+    last_step_ = snapshot.step;
+    bytes_ += sizeof(header) + payload_.size();
+    frames_++;
+}
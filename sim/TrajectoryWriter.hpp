@@ -0,0 +1,98 @@
+// TrajectoryWriter.hpp
+#ifndef TRAJECTORY_WRITER_HPP
+#define TRAJECTORY_WRITER_HPP
+
+#include "Trajectory.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Reactor;
+
+struct TrajectoryOptions {
+    unsigned quantBits        = 16;    // per coordinate, across the reactor bounds
+    unsigned sampleInterval   = 1;     // record every Nth step
+    unsigned keyframeInterval = 300;   // frames between full frames
+    size_t   maxPending       = 4;     // queued frames before record() waits
+};
+
+// Records every molecule's position at each sampled step (format in
+// Trajectory.hpp). Attach record() as a step observer: it only copies ids,
+// types and positions; sorting, quantising, delta coding and writing run
+// on a background thread. When that thread falls `maxPending` frames
+// behind, record() waits for it rather than drop frames.
+//
+// A step that goes backwards (after a rewind) starts a new keyframe.
+class TrajectoryWriter {
+private:
+    struct Snapshot {
+        struct Entry {
+            std::uint32_t id;
+            std::uint8_t  type;
+            float         x, y;
+        };
+
+        std::uint64_t      step = 0;
+        double             simTime = 0;
+        float              boundsX = 0, boundsY = 0, boundsWidth = 0, boundsHeight = 0;
+        std::vector<Entry> molecules;
+    };
+
+    std::ofstream     file_;
+    std::string       path_;
+    TrajectoryOptions options_;
+
+    std::thread                            thread_;
+    std::mutex                             mutex_;
+    std::condition_variable                ready_cv_;   // a snapshot was queued, or stop
+    std::condition_variable                free_cv_;    // a snapshot was written
+    std::deque<std::unique_ptr<Snapshot>>  queue_;
+    std::vector<std::unique_ptr<Snapshot>> free_;
+    size_t                                 allocated_ = 0;
+    bool                                   stop_ = false;
+
+    // Encoder state, owned by the background thread.
+    std::vector<TrajectoryState> previous_;
+    std::vector<TrajectoryState> current_;
+    std::vector<std::uint8_t>    payload_;
+    std::vector<std::uint8_t>    survivors_;
+    std::vector<std::uint32_t>   removed_;
+    std::vector<size_t>          spawned_;
+    std::uint64_t                last_step_ = 0;
+    unsigned                     since_keyframe_ = 0;
+
+    std::atomic<std::uint64_t> frames_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> stalls_{0};
+
+    void run   ();
+    void encode(Snapshot& snapshot);
+
+public:
+    TrajectoryWriter() = default;
+    ~TrajectoryWriter();
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    // Creates (truncates) the file at `path` and starts the writer thread.
+    bool open (const std::string& path, const TrajectoryOptions& options = TrajectoryOptions());
+    // Writes out everything queued, then stops the thread.
+    void close();
+    bool isOpen() const { return thread_.joinable(); }
+
+    void record(const Reactor& reactor);
+
+    const std::string& getPath         () const { return path_; }
+    std::uint64_t      getFramesWritten() const { return frames_; }
+    std::uint64_t      getBytesWritten () const { return bytes_; }
+    // record() calls that had to wait for the writer thread.
+    std::uint64_t      getStalls       () const { return stalls_; }
+};
+
+#endif // TRAJECTORY_WRITER_HPP
@@ -0,0 +1,54 @@
+// Vec2.hpp
+#ifndef VEC2_HPP
+#define VEC2_HPP
+
+#include "Precision.hpp"
+#include <cmath>
+
+// Packed 2D vector for molecule state: two scalars, no padding, and
+// usable in constant expressions. Distance checks should compare
+// lengthSquared()/distanceSquared() against squared radii rather than
+// taking a square root.
+template<typename T>
+struct Vec2T {
+    T x = 0;
+    T y = 0;
+
+    constexpr Vec2T() = default;
+    constexpr Vec2T(T x, T y) : x(x), y(y) {}
+
+    constexpr T    getX() const { return x; }
+    constexpr T    getY() const { return y; }
+    constexpr void setX(T value) { x = value; }
+    constexpr void setY(T value) { y = value; }
+
+    constexpr Vec2T operator+(const Vec2T& o) const { return Vec2T(x + o.x, y + o.y); }
+    constexpr Vec2T operator-(const Vec2T& o) const { return Vec2T(x - o.x, y - o.y); }
+    constexpr Vec2T operator-()               const { return Vec2T(-x, -y); }
+    constexpr Vec2T operator*(T s)            const { return Vec2T(x * s, y * s); }
+
+    constexpr Vec2T& operator+=(const Vec2T& o) { x += o.x; y += o.y; return *this; }
+    constexpr Vec2T& operator-=(const Vec2T& o) { x -= o.x; y -= o.y; return *this; }
+    constexpr Vec2T& operator*=(T s)            { x *= s;   y *= s;   return *this; }
+
+    constexpr bool operator==(const Vec2T& o) const { return x == o.x && y == o.y; }
+    constexpr bool operator!=(const Vec2T& o) const { return !(*this == o); }
+
+    constexpr T dot            (const Vec2T& o) const { return x * o.x + y * o.y; }
+    constexpr T lengthSquared  ()               const { return x * x + y * y; }
+    constexpr T distanceSquared(const Vec2T& o) const { return (*this - o).lengthSquared(); }
+    T           length         ()               const { return std::sqrt(lengthSquared()); }
+
+    // this + v * s in one step, e.g. position.addScaled(velocity, dt).
+    constexpr Vec2T  addScaled(const Vec2T& v, T s) const { return Vec2T(x + v.x * s, y + v.y * s); }
+    constexpr Vec2T& moveBy   (const Vec2T& v, T s)       { x += v.x * s; y += v.y * s; return *this; }
+};
+
+template<typename T>
+constexpr Vec2T<T> operator*(T s, const Vec2T<T>& v) { return v * s; }
+
+using Vec2 = Vec2T<Real>;
+
+static_assert(sizeof(Vec2) == 2 * sizeof(Real), "Vec2 must stay packed");
+
+#endif // VEC2_HPP
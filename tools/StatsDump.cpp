@@ -0,0 +1,52 @@
+// StatsDump.cpp
+// Prints a time range of a statistics archive as CSV.
+//
+//   ReactorStatsDump reactor_stats.rsa                    whole run
+//   ReactorStatsDump reactor_stats.rsa --from 60 --to 120 --max 1000
+#include "sim/StatsArchive.hpp"
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " archive [--from s] [--to s] [--max samples]" << std::endl;
+        return 2;
+    }
+
+    double from = -std::numeric_limits<double>::infinity();
+    double to   =  std::numeric_limits<double>::infinity();
+    size_t maxSamples = 0;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+
+        if      (arg == "--from") from       = std::stod(value);
+        else if (arg == "--to")   to         = std::stod(value);
+        else if (arg == "--max")  maxSamples = std::stoul(value);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    StatsArchiveReader reader;
+    if (!reader.open(argv[1])) {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<StatsSample> samples;
+    reader.readTimeRange(from, to, samples, maxSamples);
+
+    std::cout << "step,time,total,round,square,energy,temperature\n";
+    for (const auto& s : samples) {
+        std::cout << s.step << ',' << s.time << ',' << s.total << ',' << s.round << ','
+                  << s.square << ',' << s.energy << ',' << s.temperature << '\n';
+    }
+    std::cerr << samples.size() << " of " << reader.getSampleCount() << " samples, "
+              << reader.getChunkCount() << " chunks" << std::endl;
+    return 0;
+}
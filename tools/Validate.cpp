@@ -0,0 +1,80 @@
+// Validate.cpp
+// Runs the same seeded scenario on the plain serial engine and on a
+// candidate engine configuration in lockstep, and reports the first step
+// and molecule where they disagree.
+//
+//   ReactorValidate --sim-threads 8 --rounds 3000 --squares 300 --steps 600
+//   ReactorValidate --reorder 50          expected to diverge: order changes pairing
+#include "sim/ReactorValidator.hpp"
+#include <iostream>
+#include <string>
+
+static void printUsage() {
+    std::cerr << "usage: ReactorValidate [--rounds n] [--squares n] [--width w] [--height h]\n"
+                 "                       [--steps n] [--dt s] [--seed s] [--temp t] [--swept 0|1]\n"
+                 "                       [--sim-threads n] [--reorder steps]\n"
+                 "                       [--tol-position x] [--tol-velocity x] [--tol-relative x]\n";
+}
+
+int main(int argc, char** argv) {
+    ValidationConfig config;
+    config.reference.steps = 600;
+    EnsembleConfig& scenario = config.reference;
+    EnsembleConfig  engine;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        std::string value = argv[++i];
+
+        if      (arg == "--rounds")       scenario.roundMolecules  = std::stoi(value);
+        else if (arg == "--squares")      scenario.squareMolecules = std::stoi(value);
+        else if (arg == "--width")        scenario.width           = std::stof(value);
+        else if (arg == "--height")       scenario.height          = std::stof(value);
+        else if (arg == "--steps")        scenario.steps           = std::stoi(value);
+        else if (arg == "--dt")           scenario.dt              = std::stof(value);
+        else if (arg == "--seed")         scenario.seed            = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--temp")         scenario.wallTemperature = std::stof(value);
+        else if (arg == "--swept")        scenario.sweptCollisions = value != "0";
+        else if (arg == "--sim-threads")  engine.simWorkers        = static_cast<unsigned int>(std::stoul(value));
+        else if (arg == "--reorder")      engine.reorderInterval   = std::stoi(value);
+        else if (arg == "--tol-position") config.tolerance.position = std::stof(value);
+        else if (arg == "--tol-velocity") config.tolerance.velocity = std::stof(value);
+        else if (arg == "--tol-relative") config.tolerance.relative = std::stof(value);
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    config.candidate = scenario;
+    config.candidate.simWorkers      = engine.simWorkers;
+    config.candidate.reorderInterval = engine.reorderInterval;
+
+    std::cerr << "Reference: serial engine. Candidate: " << config.candidate.simWorkers << " sim threads, reorder "
+              << config.candidate.reorderInterval << ". " << scenario.steps << " steps" << std::endl;
+
+    ValidationReport report = ReactorValidator::run(config, [](long long step) {
+        if (step % 100 == 0) std::cerr << "  step " << step << std::endl;
+    });
+
+    std::cout << "max position error " << report.maxPositionError
+              << ", velocity " << report.maxVelocityError
+              << ", relative energy " << report.maxEnergyError << '\n';
+
+    const Divergence& d = report.first;
+    if (!d.diverged()) {
+        std::cout << "OK: no divergence in " << report.steps << " steps" << std::endl;
+        return 0;
+    }
+
+    std::cout << "DIVERGED at step " << d.step << ": " << d.what;
+    if (d.moleculeId != 0) {
+        std::cout << " of molecule #" << d.moleculeId << " (" << d.moleculesOff << " molecules out of tolerance)";
+    }
+    std::cout << ", reference " << d.reference << ", candidate " << d.candidate << std::endl;
+    return 1;
+}
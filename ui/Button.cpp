@@ -42,9 +42,7 @@ void Button::onMouseLeave() {
     pressed_ = false; 
 }
 
-void Button::render(sf::RenderWindow& window) {
-    if (!isVisible()) return;
-    
+void Button::draw(sf::RenderWindow& window) {
     sf::RectangleShape shape(sf::Vector2f(rect_.width, rect_.height));
     shape.setPosition(rect_.left, rect_.top);
     
@@ -26,7 +26,7 @@ public:
     void onMouseEnter() override;
     void onMouseLeave() override;
     
-    void render(sf::RenderWindow& window) override;
+    void draw(sf::RenderWindow& window) override;
     
     void setOnClick(std::function<void()> callback) { onClick_ = std::move(callback); }
     void setLabel(const std::string& label) { label_ = label; }
@@ -20,7 +20,13 @@ void ClockWidget::onIdle() {
 }
 
 void ClockWidget::updateTimeDisplay() {
-    time_text_.setString(getCurrentTimeString());
+    // Only a changed string needs a redraw.
+    std::string text = getCurrentTimeString();
+    if (text != shown_) {
+        shown_ = text;
+        time_text_.setString(text);
+        invalidate();
+    }
     
     sf::FloatRect text_bounds = time_text_.getLocalBounds();
     time_text_.setPosition(
@@ -54,9 +60,7 @@ std::string ClockWidget::getCurrentTimeString() const {
     return ss.str();
 }
 
-void ClockWidget::render(sf::RenderWindow& window) {
-    if (!isVisible()) return;
-    
+void ClockWidget::draw(sf::RenderWindow& window) {
     sf::RectangleShape background(sf::Vector2f(rect_.width, rect_.height));
     background.setPosition(rect_.left, rect_.top);
     background.setFillColor(sf::Color(30, 30, 40, 180));
@@ -65,6 +69,4 @@ void ClockWidget::render(sf::RenderWindow& window) {
     window.draw(background);
     
     window.draw(time_text_);
-    
-    Widget::render(window);
 }
\ No newline at end of file
@@ -13,15 +13,19 @@ private:
     sf::Text time_text_;
     sf::Font* font_;
     sf::Clock clock_;
+    std::string shown_;
     bool show_milliseconds_ = false;
 
 public:
     ClockWidget(sf::Font* font = nullptr, bool show_ms = false);
     
     void onIdle() override;
-    void render(sf::RenderWindow& window) override;
+    void draw  (sf::RenderWindow& window) override;
     
-    void setTimeFormat(bool show_ms) { show_milliseconds_ = show_ms; }
+    void setTimeFormat(bool show_ms) { show_milliseconds_ = show_ms; updateTimeDisplay(); }
+    bool showsMilliseconds() const   { return show_milliseconds_; }
+    // How often onIdle() should run to keep the display current.
+    float getUpdateInterval() const  { return show_milliseconds_ ? 0.016f : 1.0f; }
     void setTextColor(const sf::Color& color) { time_text_.setFillColor(color); }
     void setCharacterSize(unsigned int size) { time_text_.setCharacterSize(size); }
     
@@ -22,10 +22,6 @@ void Container::onMouseUp  (MouseButtonEvent& event) {
     Widget::onMouseUp(event);
 }
 
-void Container::render     (sf::RenderWindow& window) {
-    Widget::render(window);
-}
-
 void Container::updateLayout() {
     Widget::updateLayout();
 }
\ No newline at end of file
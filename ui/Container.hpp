@@ -14,8 +14,6 @@ public:
     void onMouseMove(MouseMoveEvent&   event) override;
     void onMouseDown(MouseButtonEvent& event) override;
     void onMouseUp  (MouseButtonEvent& event) override;
-    
-    void render    (sf::RenderWindow& window) override;
 
 protected:
     void updateLayout() override;
@@ -20,6 +20,13 @@ EventResult MouseButtonEvent::apply(Widget* widget) {
     return bubbling_ ? EventResult::PROPAGATE : EventResult::CONSUME;
 }
 
+EventResult MouseWheelEvent::apply(Widget* widget) {
+    if (!widget) return EventResult::PROPAGATE;
+    
+    widget->onMouseWheel(*this);
+    return bubbling_ ? EventResult::PROPAGATE : EventResult::CONSUME;
+}
+
 EventResult IdleEvent::apply(Widget* widget) {
     if (!widget) return EventResult::PROPAGATE;
     
@@ -52,6 +52,19 @@ public:
     EventResult apply(Widget* widget) override;
 };
 
+class MouseWheelEvent : public CoordEvent {
+private:
+    float delta_;
+
+public:
+    MouseWheelEvent(const sf::Vector2f& position, float delta)
+        : CoordEvent(position), delta_(delta) {}
+
+    // Notches scrolled; positive is away from the user.
+    float getDelta() const { return delta_; }
+    EventResult apply(Widget* widget) override;
+};
+
 class IdleEvent : public Event {
 public:
     IdleEvent() = default;
@@ -0,0 +1,490 @@
+// GraphWidget.cpp
+#include "GraphWidget.hpp"
+#include "Events.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const float  PADDING      = 10;
+const float  GRAPH_HEIGHT = 40;
+const double MIN_SPAN     = 16;     // samples across the plot at full zoom
+const float  WHEEL_ZOOM   = 1.25f;
+const size_t LIVE_WINDOW  = 1 << 16;   // samples kept in memory, about 18 minutes at 60 steps/s
+const size_t ARCHIVE_DETAIL = 1 << 18; // archive samples decoded for one view at most
+const double ARCHIVE_WIDEN  = 4;       // zooming out of an archived range
+}
+
+void GraphWidget::Series::push(const StatsSample& sample) {
+    total      .push_back(static_cast<float>(sample.total));
+    round      .push_back(static_cast<float>(sample.round));
+    square     .push_back(static_cast<float>(sample.square));
+    energy     .push_back(sample.energy);
+    temperature.push_back(sample.temperature);
+}
+
+void GraphWidget::Series::push(const float (&values)[StatsArchiveFormat::FIELDS]) {
+    total      .push_back(values[0]);
+    round      .push_back(values[1]);
+    square     .push_back(values[2]);
+    energy     .push_back(values[3]);
+    temperature.push_back(values[4]);
+}
+
+void GraphWidget::Series::pop() {
+    total      .pop_back();
+    round      .pop_back();
+    square     .pop_back();
+    energy     .pop_back();
+    temperature.pop_back();
+}
+
+void GraphWidget::Series::erase_front(size_t count) {
+    total      .erase_front(count);
+    round      .erase_front(count);
+    square     .erase_front(count);
+    energy     .erase_front(count);
+    temperature.erase_front(count);
+    first_step += count;
+}
+
+void GraphWidget::Series::clear() {
+    total      .clear();
+    round      .clear();
+    square     .clear();
+    energy     .clear();
+    temperature.clear();
+    first_step = 0;
+}
+
+GraphWidget::GraphWidget(Reactor& reactor, sf::Font* font)
+    : reactor_(reactor), font_(font) {
+    background_.setFillColor(sf::Color(30, 30, 30, 200));
+    setRect(sf::FloatRect(1150, 200, 300, 500));
+}
+
+void GraphWidget::updateLayout() {
+    background_.setPosition(rect_.left, rect_.top);
+    background_.setSize(sf::Vector2f(rect_.width, rect_.height));
+}
+
+void GraphWidget::record(const StatsSample& sample) {
+    while (live_.size() > 0 && live_.first_step + live_.size() > sample.step) {
+        live_.pop();
+    }
+    if (live_.size() == 0) {
+        live_.first_step = sample.step;
+    }
+    live_.push(sample);
+
+    // Trimmed in batches of a whole window; older samples are in the archive.
+    if (live_.size() >= 2 * LIVE_WINDOW) {
+        size_t drop = live_.size() - LIVE_WINDOW;
+        live_.erase_front(drop);
+        view_begin_ = std::max(0.0, view_begin_ - drop);
+    }
+}
+
+void GraphWidget::showArchiveRange(const StatsArchiveReader& reader, double from, double to) {
+    archive_reader_ = &reader;
+    archive_view_   = true;
+    loadArchive(from, to);
+}
+
+bool GraphWidget::showArchive() {
+    const StatsArchiveReader* reader = archive_source_ ? archive_source_() : nullptr;
+    if (!reader) return false;
+    showArchiveRange(*reader, reader->getFirstTime(), reader->getLastTime());
+    return true;
+}
+
+void GraphWidget::showLive() {
+    archive_view_   = false;
+    archive_reader_ = nullptr;
+    archive_.clear();
+    archive_low_.clear();
+    archive_high_.clear();
+    archive_chunks_.clear();
+    resetView();
+}
+
+void GraphWidget::loadArchive(double from, double to) {
+    archive_.clear();
+    archive_low_.clear();
+    archive_high_.clear();
+    archive_chunks_.clear();
+    archive_from_ = from;
+    archive_to_   = to;
+
+    std::vector<StatsArchiveFormat::ChunkHeader> chunks;
+    archive_reader_->readChunkSummaries(from, to, chunks);
+    size_t samples = 0;
+    for (const auto& chunk : chunks) {
+        samples += chunk.sampleCount;
+    }
+
+    if (samples <= ARCHIVE_DETAIL) {
+        std::vector<StatsSample> decoded;
+        archive_reader_->readTimeRange(from, to, decoded);
+        for (const auto& sample : decoded) {
+            archive_.push(sample);
+        }
+        if (!decoded.empty()) {
+            archive_.first_step = decoded.front().step;
+        }
+    } else {
+        float mean[StatsArchiveFormat::FIELDS];
+        for (const auto& chunk : chunks) {
+            for (int k = 0; k < StatsArchiveFormat::FIELDS; ++k) {
+                mean[k] = static_cast<float>(chunk.sumValue[k] / chunk.sampleCount);
+            }
+            archive_     .push(mean);
+            archive_low_ .push(chunk.minValue);
+            archive_high_.push(chunk.maxValue);
+        }
+        archive_chunks_ = std::move(chunks);
+        archive_.first_step = archive_chunks_.front().firstStep;
+    }
+    resetView();
+}
+
+void GraphWidget::widenArchive(double factor) {
+    if (!archive_view_) {
+        showArchive();
+        return;
+    }
+
+    double first = archive_reader_->getFirstTime(), last = archive_reader_->getLastTime();
+    if (archive_from_ <= first && archive_to_ >= last) return;
+    double middle = (archive_from_ + archive_to_) / 2;
+    double half   = std::max(archive_to_ - archive_from_, 1.0) * factor / 2;
+    loadArchive(std::max(first, middle - half), std::min(last, middle + half));
+}
+
+size_t GraphWidget::visibleCount() const {
+    const Series& series = shownSeries();
+    if (archive_view_) return series.size();
+
+    long long step = reactor_.getStepCount();
+    if (series.size() == 0 || step < static_cast<long long>(series.first_step)) return 0;
+    return std::min(series.size(), static_cast<size_t>(step - series.first_step + 1));
+}
+
+void GraphWidget::visibleRange(double& begin, double& end) const {
+    double count = static_cast<double>(visibleCount());
+    double span  = view_span_ <= 0 ? count : std::min(view_span_, count);
+    begin = follow_ ? count - span : std::clamp(view_begin_, 0.0, count - span);
+    end   = begin + span;
+}
+
+float GraphWidget::plotLeft() const {
+    return rect_.left + PADDING;
+}
+
+float GraphWidget::plotWidth() const {
+    return std::max(1.f, rect_.width - 2 * PADDING);
+}
+
+void GraphWidget::resetView() {
+    follow_     = true;
+    view_begin_ = 0;
+    view_span_  = 0;
+}
+
+void GraphWidget::zoomAt(float x, float factor) {
+    double begin, end;
+    visibleRange(begin, end);
+    double count = static_cast<double>(visibleCount());
+
+    // Out past everything loaded: the live window gives way to the whole
+    // archived run, an archived range to a wider one.
+    if (factor > 1 && end - begin >= count) {
+        widenArchive(ARCHIVE_WIDEN);
+        return;
+    }
+
+    double fraction = std::clamp(static_cast<double>((x - plotLeft()) / plotWidth()), 0.0, 1.0);
+    double anchor   = begin + fraction * (end - begin);
+
+    // In the overview, chunks that are few enough samples are read in full.
+    if (isOverview() && factor < 1) {
+        double span  = std::max(1.0, (end - begin) * factor);
+        size_t first = static_cast<size_t>(std::clamp(anchor - fraction * span, 0.0, count - 1));
+        size_t last  = std::min(archive_chunks_.size(), first + static_cast<size_t>(std::ceil(span)));
+        size_t samples = 0;
+        for (size_t c = first; c < last; ++c) {
+            samples += archive_chunks_[c].sampleCount;
+        }
+        if (samples <= ARCHIVE_DETAIL) {
+            loadArchive(archive_chunks_[first].firstTime, archive_chunks_[last - 1].lastTime);
+            return;
+        }
+    }
+    if (count <= MIN_SPAN) return;
+    double span     = std::clamp((end - begin) * factor, MIN_SPAN, count);
+    if (span >= count) {
+        resetView();
+        return;
+    }
+
+    view_span_  = span;
+    view_begin_ = std::clamp(anchor - fraction * span, 0.0, count - span);
+    follow_     = view_begin_ + span >= count - 0.5;
+}
+
+void GraphWidget::panBy(float dx) {
+    if (view_span_ <= 0) return;
+
+    double begin, end;
+    visibleRange(begin, end);
+    double count = static_cast<double>(visibleCount());
+    double span  = end - begin;
+
+    view_begin_ = std::clamp(begin - dx / plotWidth() * span, 0.0, count - span);
+    follow_     = view_begin_ + span >= count - 0.5;
+}
+
+void GraphWidget::onMouseDown(MouseButtonEvent& event) {
+    if (!event.isPressed()) return;
+    dragging_ = true;
+    drag_x_   = event.getPosition().x;
+    event.stopPropagation();
+}
+
+void GraphWidget::onMouseMove(MouseMoveEvent& event) {
+    if (!dragging_) return;
+    panBy(event.getPosition().x - drag_x_);
+    drag_x_ = event.getPosition().x;
+}
+
+void GraphWidget::onMouseUp(MouseButtonEvent&) {
+    dragging_ = false;
+}
+
+void GraphWidget::onMouseLeave() {
+    dragging_ = false;
+}
+
+void GraphWidget::onMouseWheel(MouseWheelEvent& event) {
+    zoomAt(event.getPosition().x, std::pow(WHEEL_ZOOM, -event.getDelta()));
+    event.stopPropagation();
+}
+
+void GraphWidget::draw(sf::RenderWindow& window) {
+    window.draw(background_);
+
+    double begin, end;
+    visibleRange(begin, end);
+
+    sf::Vector2f graph_pos(rect_.left, rect_.top);
+
+    drawViewLabel(window, begin, end);
+    drawSeries(window, &Series::total,       begin, end, sf::Color::Cyan,   graph_pos.y + 30 , "Total");
+    drawSeries(window, &Series::round,       begin, end, sf::Color::White,  graph_pos.y + 80 , "Round");
+    drawSeries(window, &Series::square,      begin, end, sf::Color::Green,  graph_pos.y + 130, "Square");
+    drawSeries(window, &Series::energy,      begin, end, sf::Color::Yellow, graph_pos.y + 180, "Energy");
+    drawSeries(window, &Series::temperature, begin, end, sf::Color::Red,    graph_pos.y + 230, "Temp");
+
+    drawSpeedHistogram(window, graph_pos.y + 290, graph_pos);
+    drawReactionStats (window, graph_pos.y + 400, graph_pos);
+
+    scratch_.reset();
+}
+
+void GraphWidget::drawViewLabel(sf::RenderWindow& window, double begin, double end) {
+    if (!font_ || end <= begin) return;
+
+    std::uint64_t from = shownSeries().first_step + static_cast<std::uint64_t>(begin);
+    std::uint64_t to   = shownSeries().first_step + static_cast<std::uint64_t>(end) - 1;
+    if (isOverview()) {
+        from = archive_chunks_[static_cast<size_t>(begin)].firstStep;
+        to   = archive_chunks_[static_cast<size_t>(end) - 1].lastStep;
+    }
+    std::string label = "Steps " + std::to_string(from) + "-" + std::to_string(to);
+    if (archive_view_) label += isOverview() ? " (archive, per chunk)" : " (archive)";
+
+    sf::Text text(label, *font_, 10);
+    text.setPosition(rect_.left + rect_.width - PADDING - text.getLocalBounds().width, rect_.top + 5);
+    text.setFillColor(sf::Color(150, 150, 150));
+    window.draw(text);
+}
+
+void GraphWidget::drawReactionStats(sf::RenderWindow& window, float y_top, const sf::Vector2f& graph_pos) {
+    const float CELL = 3.f;
+
+    const ReactionStats& stats = reactor_.getReactionStats();
+    float map_w = stats.getHeatCols() * CELL;
+    float map_h = stats.getHeatRows() * CELL;
+    if (y_top + map_h > graph_pos.y + background_.getSize().y) return;
+
+    if (font_) {
+        sf::Text title("Reactions: step  |  last 1 s (detected/executed)", *font_, 10);
+        title.setPosition(graph_pos.x + PADDING, y_top - 15);
+        title.setFillColor(sf::Color(200, 200, 200));
+        window.draw(title);
+
+        const ReactionStats::Counts& step   = stats.getLastStep();
+        const ReactionStats::Counts& second = stats.getLastSecond();
+        float line_y = y_top;
+        for (int a = 0; a < ReactionStats::TYPES; ++a) {
+            for (int b = 0; b < ReactionStats::TYPES; ++b) {
+                std::string line = std::string(ReactionStats::pairName(a, b)) + ": " +
+                                   std::to_string(step.executed[a][b]) + "  |  " +
+                                   std::to_string(second.detected[a][b]) + "/" +
+                                   std::to_string(second.executed[a][b]);
+                sf::Text text(line, *font_, 10);
+                text.setPosition(graph_pos.x + PADDING, line_y);
+                text.setFillColor(a == 1 && b == 1 ? sf::Color(255, 150, 80) : sf::Color::White);
+                window.draw(text);
+                line_y += 14;
+            }
+        }
+
+        long long held = second.totalDeferred() + second.totalRejected();
+        sf::Text limits("deferred " + std::to_string(second.totalDeferred()) +
+                        "  rejected " + std::to_string(second.totalRejected()) + " (1 s)", *font_, 10);
+        limits.setPosition(graph_pos.x + PADDING, line_y);
+        limits.setFillColor(held > 0 ? sf::Color(255, 200, 0) : sf::Color(150, 150, 150));
+        window.draw(limits);
+    }
+
+    const std::vector<float>& heat = stats.getRecentHeatMap();
+    float max_val = 1e-3f;
+    for (float v : heat) max_val = std::max(max_val, v);
+
+    float map_x = graph_pos.x + background_.getSize().x - PADDING - map_w;
+    ScratchVector<sf::Vertex> cells{ArenaAllocator<sf::Vertex>(scratch_)};
+    cells.reserve(static_cast<size_t>(stats.getHeatRows()) * stats.getHeatCols() * 4);
+    for (int y = 0; y < stats.getHeatRows(); ++y) {
+        for (int x = 0; x < stats.getHeatCols(); ++x) {
+            float v = heat[static_cast<size_t>(y) * stats.getHeatCols() + x] / max_val;
+            sf::Color color(static_cast<sf::Uint8>(255 * v), static_cast<sf::Uint8>(80 * v), 40, 255);
+            float x0 = map_x + x * CELL, y0 = y_top + y * CELL;
+            cells.emplace_back(sf::Vector2f(x0,        y0),        color);
+            cells.emplace_back(sf::Vector2f(x0 + CELL, y0),        color);
+            cells.emplace_back(sf::Vector2f(x0 + CELL, y0 + CELL), color);
+            cells.emplace_back(sf::Vector2f(x0,        y0 + CELL), color);
+        }
+    }
+    window.draw(cells.data(), cells.size(), sf::Quads);
+}
+
+void GraphWidget::drawSpeedHistogram(sf::RenderWindow& window, float y_top, const sf::Vector2f& graph_pos) {
+    const int HIST_HEIGHT = 80;
+
+    const SpeedHistogram& hist = reactor_.getSpeedHistogram();
+    if (hist.bins <= 0 || y_top + HIST_HEIGHT > graph_pos.y + background_.getSize().y) return;
+
+    const sf::Color barColors  [SpeedHistogram::SPECIES] = {sf::Color(255, 255, 255, 110), sf::Color(0, 255, 0, 110)};
+    const sf::Color curveColors[SpeedHistogram::SPECIES] = {sf::Color::White,              sf::Color::Green};
+
+    float max_val = 1;
+    for (int s = 0; s < SpeedHistogram::SPECIES; ++s) {
+        for (int b = 0; b < hist.bins; ++b) {
+            max_val = std::max({max_val, static_cast<float>(hist.counts[s][b]), hist.expected(s, b)});
+        }
+    }
+
+    float bar_width = (background_.getSize().x - 2 * PADDING) / hist.bins;
+    float bottom = y_top + HIST_HEIGHT;
+
+    for (int s = 0; s < SpeedHistogram::SPECIES; ++s) {
+        if (hist.total[s] == 0) continue;
+
+        ScratchVector<sf::Vertex> bars {ArenaAllocator<sf::Vertex>(scratch_)};
+        ScratchVector<sf::Vertex> curve{ArenaAllocator<sf::Vertex>(scratch_)};
+        bars .reserve(static_cast<size_t>(hist.bins) * 4);
+        curve.reserve(static_cast<size_t>(hist.bins));
+
+        for (int b = 0; b < hist.bins; ++b) {
+            float x0 = graph_pos.x + PADDING + b * bar_width;
+            float x1 = x0 + bar_width;
+            float y  = bottom - hist.counts[s][b] / max_val * HIST_HEIGHT;
+
+            bars.emplace_back(sf::Vector2f(x0, bottom), barColors[s]);
+            bars.emplace_back(sf::Vector2f(x1, bottom), barColors[s]);
+            bars.emplace_back(sf::Vector2f(x1, y),      barColors[s]);
+            bars.emplace_back(sf::Vector2f(x0, y),      barColors[s]);
+
+            float fit = bottom - hist.expected(s, b) / max_val * HIST_HEIGHT;
+            curve.emplace_back(sf::Vector2f((x0 + x1) / 2, fit), curveColors[s]);
+        }
+
+        window.draw(bars .data(), bars .size(), sf::Quads);
+        window.draw(curve.data(), curve.size(), sf::LineStrip);
+    }
+
+    if (font_) {
+        sf::Text text("Speed (bars) vs Maxwell-Boltzmann fit", *font_, 10);
+        text.setPosition(graph_pos.x + 10, y_top - 15);
+        text.setFillColor(sf::Color(200, 200, 200));
+        window.draw(text);
+    }
+}
+
+void GraphWidget::drawSeries(sf::RenderWindow& window, Field field, double begin, double end,
+                             sf::Color color, float y_top, const std::string& label) {
+    if (font_) {
+        sf::Text text(label, *font_, 10);
+        text.setPosition(rect_.left + 10, y_top - 15);
+        text.setFillColor(color);
+        window.draw(text);
+    }
+
+    // The overview draws each chunk's extremes around its mean.
+    const SeriesIndex<float>& series = shownSeries().*field;
+    const SeriesIndex<float>& low    = isOverview() ? archive_low_ .*field : series;
+    const SeriesIndex<float>& high   = isOverview() ? archive_high_.*field : series;
+
+    size_t first = static_cast<size_t>(std::floor(begin));
+    size_t last  = std::min(series.size(), static_cast<size_t>(std::ceil(end)));
+    if (first >= last) return;
+
+    SeriesIndex<float>::Summary range = high.query(first, last);
+    float max_val = range.max > 0 ? range.max : 1;
+    float left    = plotLeft();
+    float width   = plotWidth();
+    auto  yOf     = [&](double value) { return y_top + GRAPH_HEIGHT - static_cast<float>(value / max_val) * GRAPH_HEIGHT; };
+
+    size_t samples = last - first;
+    size_t columns = static_cast<size_t>(width);
+    sf::Color band_color(color.r, color.g, color.b, 90);
+    if (samples <= columns) {
+        // Few enough samples to plot each one.
+        ScratchVector<sf::Vertex> lines{ArenaAllocator<sf::Vertex>(scratch_)};
+        ScratchVector<sf::Vertex> band {ArenaAllocator<sf::Vertex>(scratch_)};
+        lines.reserve(samples);
+        double scale = end - begin > 1 ? width / (end - begin - 1) : 0;
+        for (size_t i = first; i < last; ++i) {
+            float x = left + static_cast<float>((i - begin) * scale);
+            lines.emplace_back(sf::Vector2f(x, yOf(series[i])), color);
+            if (isOverview()) {
+                band.emplace_back(sf::Vector2f(x, yOf(low [i])), band_color);
+                band.emplace_back(sf::Vector2f(x, yOf(high[i])), band_color);
+            }
+        }
+        window.draw(band .data(), band .size(), sf::Lines);
+        window.draw(lines.data(), lines.size(), sf::LineStrip);
+        return;
+    }
+
+    // One column per pixel: the min-max band, and the mean through it.
+    ScratchVector<sf::Vertex> band{ArenaAllocator<sf::Vertex>(scratch_)};
+    ScratchVector<sf::Vertex> mean{ArenaAllocator<sf::Vertex>(scratch_)};
+    band.reserve(columns * 2);
+    mean.reserve(columns);
+    for (size_t c = 0; c < columns; ++c) {
+        size_t from = first + samples * c / columns;
+        size_t to   = std::max(first + samples * (c + 1) / columns, from + 1);
+        SeriesIndex<float>::Summary column = series.query(from, to);
+        if (isOverview()) {
+            column.min = low .query(from, to).min;
+            column.max = high.query(from, to).max;
+        }
+        float x = left + c + 0.5f;
+        band.emplace_back(sf::Vector2f(x, yOf(column.min)), band_color);
+        band.emplace_back(sf::Vector2f(x, yOf(column.max)), band_color);
+        mean.emplace_back(sf::Vector2f(x, yOf(column.mean())), color);
+    }
+    window.draw(band.data(), band.size(), sf::Lines);
+    window.draw(mean.data(), mean.size(), sf::LineStrip);
+}
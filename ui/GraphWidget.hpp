@@ -0,0 +1,110 @@
+// GraphWidget.hpp
+#ifndef GRAPH_WIDGET_HPP
+#define GRAPH_WIDGET_HPP
+
+#include "Widget.hpp"
+#include "../sim/Reactor.hpp"
+#include "../sim/ScratchArena.hpp"
+#include "../sim/SeriesIndex.hpp"
+#include "../sim/StatsArchive.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// History graphs, speed histogram and reaction counters of a reactor.
+// The graphs keep the last LIVE_WINDOW samples and can be zoomed (wheel)
+// and panned (drag) along the time axis. Zooming out past the live window
+// switches to the stats archive, which is read a range at a time: sample
+// by sample when the range is short enough, else one entry per archive
+// chunk from the summaries in its header. Each plotted column is one
+// range query on the series index, so a redraw costs O(width * log n).
+class GraphWidget : public Widget {
+private:
+    struct Series {
+        SeriesIndex<float> total, round, square, energy, temperature;
+        std::uint64_t      first_step = 0;
+
+        void   push       (const StatsSample& sample);
+        void   push       (const float (&values)[StatsArchiveFormat::FIELDS]);
+        void   pop        ();
+        void   erase_front(size_t count);
+        void   clear      ();
+        size_t size       () const { return total.size(); }
+    };
+    using Field = SeriesIndex<float> Series::*;
+
+    Reactor& reactor_;
+    sf::Font* font_;
+    sf::RectangleShape background_;
+    ScratchArena scratch_;   // vertices of the current draw() call
+
+    Series live_;
+
+    // Archive view. In the overview (archive_chunks_ not empty) each entry
+    // is one chunk: its mean in archive_, its extremes in the other two.
+    std::function<const StatsArchiveReader*()>   archive_source_;
+    const StatsArchiveReader*                    archive_reader_ = nullptr;
+    Series                                       archive_, archive_low_, archive_high_;
+    std::vector<StatsArchiveFormat::ChunkHeader> archive_chunks_;
+    double                                       archive_from_ = 0, archive_to_ = 0;
+    bool                                         archive_view_ = false;
+
+    bool   follow_     = true;   // keeps the newest sample at the right edge
+    double view_begin_ = 0;      // first visible sample when not following
+    double view_span_  = 0;      // visible samples; 0 shows the whole series
+
+    bool  dragging_ = false;
+    float drag_x_   = 0;
+
+public:
+    GraphWidget(Reactor& reactor, sf::Font* font = nullptr);
+
+    // Step observer feed. A sample for a step that was already recorded
+    // (the reactor was rewound and stepped on) drops the old future first.
+    void record(const StatsSample& sample);
+
+    // Opens the archive on demand (null when there is none), for zooming
+    // out past the live window and for showArchive().
+    void setArchiveSource(std::function<const StatsArchiveReader*()> source) { archive_source_ = std::move(source); }
+    // Shows [from, to] seconds of an archived run instead of the live
+    // series. `reader` must outlive the archive view.
+    void showArchiveRange(const StatsArchiveReader& reader, double from, double to);
+    // The whole archived run; false without an archive source.
+    bool showArchive     ();
+    void showLive        ();
+    bool isShowingArchive() const { return archive_view_; }
+
+    void zoomAt  (float x, float factor);
+    void panBy   (float dx);
+    void resetView();
+
+    void onMouseMove (MouseMoveEvent&   event) override;
+    void onMouseDown (MouseButtonEvent& event) override;
+    void onMouseUp   (MouseButtonEvent& event) override;
+    void onMouseWheel(MouseWheelEvent&  event) override;
+    void onMouseLeave() override;
+
+    void draw(sf::RenderWindow& window) override;
+
+private:
+    const Series& shownSeries() const { return archive_view_ ? archive_ : live_; }
+    // Samples available to show; a rewound reactor hides its recorded future.
+    size_t visibleCount() const;
+    void   visibleRange(double& begin, double& end) const;
+    bool   isOverview  () const { return archive_view_ && !archive_chunks_.empty(); }
+    void   loadArchive (double from, double to);
+    void   widenArchive(double factor);
+    float  plotLeft () const;
+    float  plotWidth() const;
+
+    void updateLayout() override;
+    void drawSeries(sf::RenderWindow& window, Field field, double begin, double end,
+                    sf::Color color, float y_top, const std::string& label);
+    void drawViewLabel     (sf::RenderWindow& window, double begin, double end);
+    void drawSpeedHistogram(sf::RenderWindow& window, float y_top, const sf::Vector2f& graph_pos);
+    void drawReactionStats (sf::RenderWindow& window, float y_top, const sf::Vector2f& graph_pos);
+};
+
+#endif // GRAPH_WIDGET_HPP
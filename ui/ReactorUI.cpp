@@ -1,15 +1,48 @@
 // ReactorUI.cpp
 #include "ReactorUI.hpp"
-#include "ClockWidget.hpp"
+#include <cmath>
+#include <fstream>
 #include <iostream>
 
+namespace {
+const int    REACTION_BUDGET = 200;
+const size_t POPULATION_CAP  = 10000;
+const float  SINGLE_STEP_DT  = 1.f / 60.f;
+const unsigned FRAME_CAPS[]  = {30, 60, 120, 0};
+const float  PICK_RADIUS     = 8.f;   // screen pixels
+const float  DENSITY_RADIUS  = 20.f;  // reactor units
+const size_t HISTORY_KEYFRAME_STEPS = 120;
+const size_t HISTORY_BUDGET  = 256 << 20;
+const double SCRUB_SECONDS   = 5.0;
+const float  FAST_FORWARD_BUDGET  = 0.02f;  // seconds of stepping per frame
+const unsigned FAST_FORWARD_PRESENT = 4;    // present every Nth frame
+const double FAST_FORWARD_RATIO_WINDOW = 0.5;
+const float  LAYOUT_MARGIN     = 10.f;
+}
+
 ReactorUI::ReactorUI(Reactor& reactor) 
     : reactor_(reactor), 
       reactor_renderer_(reactor),
-      graph_renderer_(reactor, &font_) {
+      history_(HISTORY_KEYFRAME_STEPS, HISTORY_BUDGET),
+      min_width_(static_cast<float>(reactor.getReactorWidth())),
+      max_width_(min_width_) {
+}
+
+void ReactorUI::setWidthLimits(float minWidth, float maxWidth) {
+    min_width_ = std::max(0.f, minWidth);
+    max_width_ = std::max(min_width_, maxWidth);
+}
+
+void ReactorUI::resizeReactor(int direction) {
+    // 10 units a click up to 800 wide, then a fixed share of the width, so
+    // a domain tens of thousands of units wide is a few dozen clicks away.
+    float step = std::max(10.f, std::round(static_cast<float>(reactor_.getReactorWidth()) / 80));
+    reactor_.getCommandQueue().resizeBy(direction * step, min_width_, max_width_);
 }
 
 bool ReactorUI::initialize() {
+    reactor_.addStepObserver([this](const Reactor& reactor) { history_.record(reactor); });
+    
     if (!font_.loadFromFile("../resources/arialmt.ttf")) {
         std::cerr << "Failed to load font" << std::endl;
         return false;
@@ -21,18 +54,49 @@ bool ReactorUI::initialize() {
     
     createControlWindow();
     createStatsWindow();
+    reactor_.addStepObserver([this](const Reactor& reactor) {
+        graph_widget_->record(StatsSample::fromReactor(reactor));
+    });
     createReactorWindow();
+    createPlaybackWindow();
     createClockWidget();
+    openStatsArchive();
     
     return true;
 }
 
+void ReactorUI::openStatsArchive() {
+    if (!stats_archive_.open("reactor_stats.rsa")) {
+        std::cerr << "Failed to create reactor_stats.rsa, keeping full history in memory" << std::endl;
+        return;
+    }
+
+    // The archive keeps every sample; the live graphs only need a window.
+    reactor_.setHistoryLimit(2000);
+    reactor_.addStepObserver([this](const Reactor& reactor) {
+        stats_archive_.append(StatsSample::fromReactor(reactor));
+    });
+    app_.getTimers().subscribe(1.0f, [this]() { stats_archive_.flush(); });
+}
+
 void ReactorUI::createClockWidget() {
     auto clock = std::make_unique<ClockWidget>(&font_, true);
     clock->setRect(sf::FloatRect(1500 - 160, 10, 150, 30));
     clock->setTextColor(sf::Color::Yellow);
-    
+    clock_ = clock.get();
     app_.getRoot()->addChild(std::move(clock));
+    updateClockResolution();
+}
+
+void ReactorUI::updateClockResolution() {
+    // Milliseconds only while the sim runs: a paused UI with nothing else
+    // going on then redraws once a second instead of every 16 ms.
+    bool milliseconds = !paused_;
+    if (!clock_ || (clock_timer_ != TimerService::NO_TIMER && clock_->showsMilliseconds() == milliseconds)) return;
+
+    clock_->setTimeFormat(milliseconds);
+    app_.getTimers().unsubscribe(clock_timer_);
+    clock_timer_ = app_.getTimers().subscribe(clock_, clock_->getUpdateInterval());
 }
 
 void ReactorUI::createControlWindow() {
@@ -40,75 +104,442 @@ void ReactorUI::createControlWindow() {
     
     auto temp_up = std::make_unique<Button>("Temp Up", &font_);
     temp_up->setRect(sf::FloatRect(20, 40, 80, 30));
-    temp_up->setOnClick([this]() { reactor_.increaseLeftWallTemperature(); });
+    temp_up->setOnClick([this]() { reactor_.getCommandQueue().adjustTemperature(1); });
     control_window_->addChild(std::move(temp_up));
     
     auto temp_down = std::make_unique<Button>("Temp Down", &font_);
     temp_down->setRect(sf::FloatRect(110, 40, 80, 30));
-    temp_down->setOnClick([this]() { reactor_.decreaseLeftWallTemperature(); });
+    temp_down->setOnClick([this]() { reactor_.getCommandQueue().adjustTemperature(-1); });
     control_window_->addChild(std::move(temp_down));
     
     auto wall_left = std::make_unique<Button>("Wall Left", &font_);
     wall_left->setRect(sf::FloatRect(200, 40, 80, 30));
-    wall_left->setOnClick([this]() { 
-        if (reactor_.getReactorWidth() > 200) {
-            reactor_.resize(reactor_.getReactorWidth() - 10);
-            reactor_renderer_.updateGraphics();
-        }
-    });
+    wall_left->setOnClick([this]() { resizeReactor(-1); });
     control_window_->addChild(std::move(wall_left));
     
     auto wall_right = std::make_unique<Button>("Wall Right", &font_);
     wall_right->setRect(sf::FloatRect(290, 40, 80, 30));
-    wall_right->setOnClick([this]() { 
-        if (reactor_.getReactorWidth() < 800) {
-            reactor_.resize(reactor_.getReactorWidth() + 10);
-            reactor_renderer_.updateGraphics();
-        }
-    });
+    wall_right->setOnClick([this]() { resizeReactor(1); });
     control_window_->addChild(std::move(wall_right));
     
     auto add_round = std::make_unique<Button>("Add Round", &font_);
     add_round->setRect(sf::FloatRect(20, 80, 100, 30));
-    add_round->setOnClick([this]() { reactor_.addRoundMolecule(); });
+    add_round->setOnClick([this]() { reactor_.getCommandQueue().addRound(); });
     control_window_->addChild(std::move(add_round));
     
     auto add_square = std::make_unique<Button>("Add Square", &font_);
     add_square->setRect(sf::FloatRect(130, 80, 100, 30));
-    add_square->setOnClick([this]() { reactor_.addSquareMolecule(); });
+    add_square->setOnClick([this]() { reactor_.getCommandQueue().addSquare(); });
     control_window_->addChild(std::move(add_square));
     
     auto remove_btn = std::make_unique<Button>("Remove Last", &font_);
     remove_btn->setRect(sf::FloatRect(240, 80, 100, 30));
-    remove_btn->setOnClick([this]() { reactor_.removeLastMolecule(); });
+    remove_btn->setOnClick([this]() { reactor_.getCommandQueue().removeLast(); });
     control_window_->addChild(std::move(remove_btn));
     
     auto clear_btn = std::make_unique<Button>("Clear All", &font_);
     clear_btn->setRect(sf::FloatRect(20, 120, 100, 30));
-    clear_btn->setOnClick([this]() { reactor_.clearAll(); });
+    clear_btn->setOnClick([this]() { reactor_.getCommandQueue().clearAll(); });
     control_window_->addChild(std::move(clear_btn));
     
+    auto swept_btn = std::make_unique<Button>("Swept CCD", &font_);
+    swept_btn->setRect(sf::FloatRect(130, 120, 100, 30));
+    swept_btn->setOnClick([this]() {
+        bool swept = reactor_.getCollisionMode() == CollisionMode::Swept;
+        reactor_.getCommandQueue().setCollisionMode(swept ? CollisionMode::Discrete : CollisionMode::Swept);
+    });
+    control_window_->addChild(std::move(swept_btn));
+    
+    auto splat_btn = std::make_unique<Button>("Splat View", &font_);
+    splat_btn->setRect(sf::FloatRect(240, 120, 100, 30));
+    splat_btn->setOnClick([this]() {
+        bool splat = reactor_renderer_.getRenderMode() == MoleculeRenderMode::Splat;
+        reactor_renderer_.setRenderMode(splat ? MoleculeRenderMode::Shapes : MoleculeRenderMode::Splat);
+    });
+    control_window_->addChild(std::move(splat_btn));
+    
+    auto reset_view = std::make_unique<Button>("Reset View", &font_);
+    reset_view->setRect(sf::FloatRect(20, 160, 100, 30));
+    reset_view->setOnClick([this]() { reactor_renderer_.resetCamera(); });
+    control_window_->addChild(std::move(reset_view));
+    
+    auto export_btn = std::make_unique<Button>("Export Stats", &font_);
+    export_btn->setRect(sf::FloatRect(130, 160, 100, 30));
+    export_btn->setOnClick([this]() {
+        std::ofstream out("reaction_stats.csv");
+        if (!out) {
+            std::cerr << "Failed to write reaction_stats.csv" << std::endl;
+            return;
+        }
+        reactor_.getReactionStats().writeCsv(out);
+    });
+    control_window_->addChild(std::move(export_btn));
+    
+    auto history_btn = std::make_unique<Button>("Full History", &font_);
+    history_btn->setRect(sf::FloatRect(240, 160, 100, 30));
+    history_btn->setOnClick([this]() {
+        if (graph_widget_->isShowingArchive()) {
+            graph_widget_->showLive();
+        } else {
+            graph_widget_->showArchive();
+        }
+    });
+    control_window_->addChild(std::move(history_btn));
+    
+    auto budget_btn = std::make_unique<Button>("", &font_);
+    Button* budget = budget_btn.get();
+    budget_btn->setRect(sf::FloatRect(20, 200, 100, 30));
+    budget_btn->setLabel(reactor_.getReactionBudget() > 0 ? "Budget: On" : "Budget: Off");
+    budget_btn->setOnClick([this, budget]() {
+        bool on = reactor_.getReactionBudget() > 0;
+        reactor_.getCommandQueue().setReactionBudget(on ? 0 : REACTION_BUDGET);
+        budget->setLabel(on ? "Budget: Off" : "Budget: On");
+    });
+    control_window_->addChild(std::move(budget_btn));
+    
+    auto cap_btn = std::make_unique<Button>("", &font_);
+    Button* cap = cap_btn.get();
+    cap_btn->setRect(sf::FloatRect(130, 200, 100, 30));
+    // The label follows the queued setting; the reactor only takes it at
+    // the next step boundary.
+    auto capLabel = [](size_t limit, PopulationPolicy policy) -> std::string {
+        if (limit == 0) return "Cap: Off";
+        switch (policy) {
+            case PopulationPolicy::Reject: return "Cap: Reject";
+            case PopulationPolicy::Merge:  return "Cap: Merge";
+            case PopulationPolicy::Defer:  return "Cap: Defer";
+        }
+        return "Cap";
+    };
+    cap_btn->setLabel(capLabel(reactor_.getPopulationCap(), reactor_.getPopulationPolicy()));
+    cap_btn->setOnClick([this, cap, capLabel]() {
+        // Off -> Reject -> Merge -> Defer -> Off
+        size_t           limit  = POPULATION_CAP;
+        PopulationPolicy policy = PopulationPolicy::Reject;
+        if (reactor_.getPopulationCap() == 0) {
+            policy = PopulationPolicy::Reject;
+        } else if (reactor_.getPopulationPolicy() == PopulationPolicy::Reject) {
+            policy = PopulationPolicy::Merge;
+        } else if (reactor_.getPopulationPolicy() == PopulationPolicy::Merge) {
+            policy = PopulationPolicy::Defer;
+        } else {
+            limit = 0;
+        }
+        reactor_.getCommandQueue().setPopulationCap(limit, policy);
+        cap->setLabel(capLabel(limit, policy));
+    });
+    control_window_->addChild(std::move(cap_btn));
+    
     app_.getRoot()->addChild(std::move(control_window_));
 }
 
 void ReactorUI::createStatsWindow() {
     stats_window_ = std::make_unique<Window>("Statistics", sf::FloatRect(1150, 10, 340, 300));
-    graph_renderer_.setPosition(1160, 80);
-    graph_renderer_.setSize(320, 260);
+
+    auto graph = std::make_unique<GraphWidget>(reactor_, &font_);
+    graph->setRect(sf::FloatRect(1160, 80, 320, 490));
+    graph_widget_ = graph.get();
+    graph_widget_->setArchiveSource([this]() -> const StatsArchiveReader* {
+        stats_archive_.flush();
+        if (!stats_archive_.isOpen() || !archive_reader_.open(stats_archive_.getPath())) return nullptr;
+        return &archive_reader_;
+    });
+    app_.getRoot()->addChild(std::move(graph));
+}
+
+void ReactorUI::createPlaybackWindow() {
+    playback_window_ = std::make_unique<Window>("Playback", sf::FloatRect(420, 10, 230, 210));
+    
+    auto pause_btn = std::make_unique<Button>("Pause", &font_);
+    Button* pause = pause_btn.get();
+    pause_btn->setRect(sf::FloatRect(430, 50, 100, 30));
+    pause_btn->setOnClick([this, pause]() {
+        setPaused(!paused_);
+        pause->setLabel(paused_ ? "Resume" : "Pause");
+    });
+    playback_window_->addChild(std::move(pause_btn));
+    
+    auto step_btn = std::make_unique<Button>("Step", &font_);
+    step_btn->setRect(sf::FloatRect(540, 50, 100, 30));
+    step_btn->setOnClick([this, pause]() {
+        requestStep();
+        pause->setLabel("Resume");
+    });
+    playback_window_->addChild(std::move(step_btn));
+    
+    auto capLabel = [this]() {
+        return frame_cap_ == 0 ? std::string("FPS: No Cap") : "FPS: " + std::to_string(frame_cap_);
+    };
+    auto cap_btn = std::make_unique<Button>(capLabel(), &font_);
+    Button* cap = cap_btn.get();
+    cap_btn->setRect(sf::FloatRect(430, 90, 100, 30));
+    cap_btn->setOnClick([this, cap, capLabel]() {
+        const size_t count = sizeof(FRAME_CAPS) / sizeof(FRAME_CAPS[0]);
+        size_t next = 0;
+        for (size_t k = 0; k < count; ++k) {
+            if (FRAME_CAPS[k] == frame_cap_) next = (k + 1) % count;
+        }
+        frame_cap_ = FRAME_CAPS[next];
+        cap->setLabel(capLabel());
+    });
+    playback_window_->addChild(std::move(cap_btn));
+    
+    auto redraw_btn = std::make_unique<Button>("Redraw: Changes", &font_);
+    Button* redraw = redraw_btn.get();
+    redraw_btn->setRect(sf::FloatRect(540, 90, 100, 30));
+    redraw_btn->setOnClick([this, redraw]() {
+        present_on_change_ = !present_on_change_;
+        redraw->setLabel(present_on_change_ ? "Redraw: Changes" : "Redraw: Always");
+    });
+    playback_window_->addChild(std::move(redraw_btn));
+    
+    auto rewind_btn = std::make_unique<Button>("<< 5s", &font_);
+    rewind_btn->setRect(sf::FloatRect(430, 130, 50, 30));
+    rewind_btn->setOnClick([this, pause]() {
+        long long step = history_.stepAtTime(reactor_.getSimTime() - SCRUB_SECONDS);
+        if (scrubTo(step)) pause->setLabel("Resume");
+    });
+    playback_window_->addChild(std::move(rewind_btn));
+    
+    auto back_btn = std::make_unique<Button>("<", &font_);
+    back_btn->setRect(sf::FloatRect(485, 130, 50, 30));
+    back_btn->setOnClick([this, pause]() {
+        if (scrubTo(getShownStep() - 1)) pause->setLabel("Resume");
+    });
+    playback_window_->addChild(std::move(back_btn));
+    
+    auto forward_btn = std::make_unique<Button>(">", &font_);
+    forward_btn->setRect(sf::FloatRect(540, 130, 50, 30));
+    forward_btn->setOnClick([this, pause]() {
+        if (scrubTo(getShownStep() + 1)) pause->setLabel("Resume");
+    });
+    playback_window_->addChild(std::move(forward_btn));
+    
+    auto live_btn = std::make_unique<Button>("Live", &font_);
+    live_btn->setRect(sf::FloatRect(595, 130, 50, 30));
+    live_btn->setOnClick([this, pause]() {
+        scrubTo(history_.getLastStep());
+        setPaused(false);
+        pause->setLabel("Pause");
+    });
+    playback_window_->addChild(std::move(live_btn));
+    
+    auto fast_btn = std::make_unique<Button>("Fast Fwd: Off", &font_);
+    Button* fast = fast_btn.get();
+    fast_btn->setRect(sf::FloatRect(430, 170, 100, 30));
+    fast_btn->setOnClick([this, fast, pause]() {
+        setFastForward(!fast_forward_);
+        if (fast_forward_) {
+            setPaused(false);
+            pause->setLabel("Pause");
+        }
+        fast->setLabel(fast_forward_ ? "Fast Fwd: On" : "Fast Fwd: Off");
+    });
+    playback_window_->addChild(std::move(fast_btn));
+    
+    app_.getRoot()->addChild(std::move(playback_window_));
+}
+
+bool ReactorUI::scrubTo(long long step) {
+    if (history_.empty()) return false;
+    step = std::clamp(step, history_.getFirstStep(), history_.getLastStep());
+    if (step == getShownStep()) return false;
+
+    setPaused(true);
+    pending_steps_ = 0;
+    scrub_step_    = step;
+    reactor_.getCommandQueue().restore(history_, step);
+    return true;
+}
+
+void ReactorUI::setPaused(bool paused) {
+    paused_ = paused;
+    dirty_  = true;
+    updateClockResolution();
+}
+
+void ReactorUI::requestStep() {
+    setPaused(true);
+    pending_steps_++;
+}
+
+void ReactorUI::setFastForward(bool on) {
+    fast_forward_   = on;
+    fast_frame_     = 0;
+    fast_sim_time_  = 0;
+    fast_wall_time_ = 0;
+    fast_ratio_     = 0;
+    fast_clock_.restart();
+    dirty_ = true;
+}
+
+bool ReactorUI::needsRedraw() const {
+    if (fast_forward_ && !paused_) return fast_frame_ % FAST_FORWARD_PRESENT == 0;
+    return !present_on_change_ || dirty_;
+}
+
+void ReactorUI::fastForward() {
+    // Stop before a step that would likely overrun the budget; the last
+    // step's cost is a good guess for the next one.
+    sf::Clock budget;
+    float step_cost = 0;
+    double start = reactor_.getSimTime();
+    do {
+        float before = budget.getElapsedTime().asSeconds();
+        reactor_.update(SINGLE_STEP_DT);
+        step_cost = budget.getElapsedTime().asSeconds() - before;
+    } while (budget.getElapsedTime().asSeconds() + step_cost < FAST_FORWARD_BUDGET);
+
+    // A gap since the last call (a pause, a dragged window) is cut down to
+    // the stepping plus one window. Dropping the whole sample instead would
+    // lose every frame once a single step takes longer than the window.
+    double stepping = budget.getElapsedTime().asSeconds();
+    double wall     = std::min<double>(fast_clock_.restart().asSeconds(), stepping + FAST_FORWARD_RATIO_WINDOW);
+    fast_sim_time_  += reactor_.getSimTime() - start;
+    fast_wall_time_ += wall;
+    if (fast_wall_time_ >= FAST_FORWARD_RATIO_WINDOW) {
+        fast_ratio_     = fast_sim_time_ / fast_wall_time_;
+        fast_sim_time_  = 0;
+        fast_wall_time_ = 0;
+    }
+    fast_frame_++;
+    dirty_ = true;
+}
+
+void ReactorUI::stepSimulation(float dt) {
+    if (!paused_ && fast_forward_) {
+        fastForward();
+    } else if (!paused_) {
+        reactor_.update(dt);
+        dirty_ = true;
+    } else if (pending_steps_ > 0) {
+        pending_steps_--;
+        reactor_.update(SINGLE_STEP_DT);
+        dirty_ = true;
+    } else if (reactor_.applyCommands() > 0) {
+        dirty_ = true;
+    }
+    scrub_step_ = -1;
+}
+
+long long ReactorUI::getShownStep() const {
+    return scrub_step_ >= 0 ? scrub_step_ : reactor_.getStepCount();
 }
 
 void ReactorUI::createReactorWindow() {
+    // The view takes the screen below the control windows and left of the
+    // graphs, whatever the reactor's size: wider reactors are fitted and
+    // can be zoomed (wheel) and panned (right drag).
+    sf::FloatRect screen = app_.getRoot()->getRect();
+    float left   = static_cast<float>(reactor_.getReactorX());
+    float top    = static_cast<float>(reactor_.getReactorY());
+    float right  = graph_widget_->getRect().left - LAYOUT_MARGIN;
+    float bottom = screen.top + screen.height - LAYOUT_MARGIN;
+    reactor_renderer_.setDisplayRect(sf::FloatRect(left, top, std::max(1.f, right - left), std::max(1.f, bottom - top)));
     reactor_renderer_.updateGraphics();
 }
 
 void ReactorUI::handleEvent(const sf::Event& event) {
+    dirty_ = true;
+    if (handleCameraEvent(event)) return;
+    if (handleSelectionEvent(event)) return;
     app_.handleEvent(event);
 }
 
+bool ReactorUI::handleCameraEvent(const sf::Event& event) {
+    switch (event.type) {
+        case sf::Event::MouseWheelScrolled: {
+            sf::Vector2f pos(static_cast<float>(event.mouseWheelScroll.x),
+                             static_cast<float>(event.mouseWheelScroll.y));
+            if (!reactor_renderer_.displayContains(pos)) return false;
+            reactor_renderer_.zoomAt(pos, std::pow(1.25f, event.mouseWheelScroll.delta));
+            return true;
+        }
+
+        case sf::Event::MouseButtonPressed: {
+            sf::Vector2f pos(static_cast<float>(event.mouseButton.x),
+                             static_cast<float>(event.mouseButton.y));
+            if (event.mouseButton.button != sf::Mouse::Right || !reactor_renderer_.displayContains(pos)) return false;
+            panning_  = true;
+            pan_last_ = pos;
+            return true;
+        }
+
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button != sf::Mouse::Right || !panning_) return false;
+            panning_ = false;
+            return true;
+
+        case sf::Event::MouseMoved: {
+            if (!panning_) return false;
+            sf::Vector2f pos(static_cast<float>(event.mouseMove.x),
+                             static_cast<float>(event.mouseMove.y));
+            reactor_renderer_.pan(pos - pan_last_);
+            pan_last_ = pos;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+bool ReactorUI::handleSelectionEvent(const sf::Event& event) {
+    if (event.type != sf::Event::MouseButtonPressed || event.mouseButton.button != sf::Mouse::Left) return false;
+
+    sf::Vector2f pos(static_cast<float>(event.mouseButton.x),
+                     static_cast<float>(event.mouseButton.y));
+    if (!reactor_renderer_.displayContains(pos)) return false;
+
+    sf::Vector2f world = reactor_renderer_.screenToWorld(pos);
+    size_t index = reactor_.findNearest(world.x, world.y, PICK_RADIUS / reactor_renderer_.getZoom());
+    selected_id_ = index == Reactor::NO_MOLECULE ? 0 : reactor_.getMolecules()[index]->getId();
+    return true;
+}
+
+void ReactorUI::drawSelection(sf::RenderWindow& window) {
+    if (selected_id_ == 0) return;
+
+    size_t index = reactor_.findById(selected_id_);
+    std::string info = "Molecule #" + std::to_string(selected_id_);
+    if (index == Reactor::NO_MOLECULE) {
+        info += ": reacted";
+    } else {
+        const Molecule& mol = *reactor_.getMolecules()[index];
+        Vector2f pos = mol.getPosition();
+        Vector2f vel = mol.getVelocity();
+        size_t nearby = reactor_.countInCircle(pos.x, pos.y, DENSITY_RADIUS);
+        info += mol.getType() == MoleculeType::Round ? " Round" : " Square";
+        info += " | Mass: "  + std::to_string(mol.getMass()).substr(0, 5) +
+                " | Vel: ("  + std::to_string(static_cast<int>(vel.x)) + ", " + std::to_string(static_cast<int>(vel.y)) + ")" +
+                " | Speed: " + std::to_string(static_cast<int>(vel.length())) +
+                " | Nearby: " + std::to_string(nearby - 1);
+
+        sf::Vector2f screen = reactor_renderer_.worldToScreen(sf::Vector2f(pos.x, pos.y));
+        float radius = std::max(PICK_RADIUS, static_cast<float>(mol.getSize().getX() * reactor_renderer_.getZoom()));
+        sf::CircleShape marker(radius);
+        marker.setOrigin(radius, radius);
+        marker.setPosition(screen);
+        marker.setFillColor(sf::Color::Transparent);
+        marker.setOutlineColor(sf::Color::Yellow);
+        marker.setOutlineThickness(1.f);
+        if (reactor_renderer_.displayContains(screen)) {
+            window.draw(marker);
+        }
+    }
+
+    sf::Text text;
+    text.setFont(font_);
+    text.setCharacterSize(12);
+    text.setFillColor(sf::Color::Yellow);
+    text.setPosition(10, 285);
+    text.setString(info);
+    window.draw(text);
+}
+
 void ReactorUI::render(sf::RenderWindow& window) {
     reactor_renderer_.render(window);
     app_.render(window);
-    graph_renderer_.render(window);
     
     sf::Text info_text;
     info_text.setFont(font_);
@@ -120,11 +551,22 @@ void ReactorUI::render(sf::RenderWindow& window) {
                       std::to_string((int)reactor_.getReactorHeight()) + 
                       " | Molecules: " + std::to_string(reactor_.getMolecules().size()) +
                       " | Temp: " + std::to_string(reactor_.getLeftWallTemperature()).substr(0, 4);
+    if (!history_.empty() && reactor_.getStepCount() < history_.getLastStep()) {
+        double behind = history_.timeOfStep(history_.getLastStep()) - reactor_.getSimTime();
+        info += " | Rewound " + std::to_string(behind).substr(0, 4) + " s";
+    }
+    if (fast_forward_ && !paused_) {
+        info += " | Fast-forward x" + std::to_string(static_cast<int>(fast_ratio_ + 0.5));
+    }
     info_text.setString(info);
     window.draw(info_text);
+
+    drawSelection(window);
 }
 
 void ReactorUI::update(float dt) {
     reactor_renderer_.updateGraphics();
-    app_.update(dt);
+    if (app_.update(dt)) {
+        dirty_ = true;
+    }
 }
\ No newline at end of file
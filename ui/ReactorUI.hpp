@@ -5,9 +5,11 @@
 #include "UIApplication.hpp"
 #include "../sim/Reactor.hpp"
 #include "../sim/ReactorRenderer.hpp"
-#include "../sim/GraphRenderer.hpp"
+#include "../sim/ReactorHistory.hpp"
+#include "GraphWidget.hpp"
 #include "Window.hpp"
 #include "Button.hpp"
+#include "ClockWidget.hpp"
 #include <memory>
 
 class ReactorUI {
@@ -15,24 +17,90 @@ private:
     Reactor& reactor_;
     UIApplication app_;
     ReactorRenderer reactor_renderer_;
-    GraphRenderer graph_renderer_;
     sf::Font font_;
 
+    StatsArchiveWriter stats_archive_;
+    StatsArchiveReader archive_reader_;
+    ReactorHistory     history_;
+
     std::unique_ptr<Window> control_window_;
     std::unique_ptr<Window> stats_window_;
+    std::unique_ptr<Window> playback_window_;
+    GraphWidget*            graph_widget_ = nullptr;
+    ClockWidget*            clock_        = nullptr;
+    TimerService::TimerId   clock_timer_  = TimerService::NO_TIMER;
+
+    bool panning_ = false;
+    sf::Vector2f pan_last_;
+
+    std::uint32_t selected_id_ = 0;
+
+    float min_width_;
+    float max_width_;
+
+    bool      paused_            = false;
+    int       pending_steps_     = 0;
+    long long scrub_step_        = -1;   // queued restore, until applied
+    bool      present_on_change_ = true;
+    bool      dirty_             = true;
+    unsigned  frame_cap_         = 60;
+
+    bool      fast_forward_   = false;
+    unsigned  fast_frame_     = 0;
+    double    fast_sim_time_  = 0;   // since the ratio was last taken
+    double    fast_wall_time_ = 0;
+    double    fast_ratio_     = 0;
+    sf::Clock fast_clock_;
 
 public:
     ReactorUI       (Reactor& reactor);
     bool initialize ();
+    // Range the "Wall Left"/"Wall Right" buttons can resize the reactor in,
+    // in reactor units; it does not depend on the screen size. Until set,
+    // the reactor keeps the width it was created with.
+    void setWidthLimits(float minWidth, float maxWidth);
     void handleEvent(const sf::Event& event);
     void render     (sf::RenderWindow& window);
     void update     (float dt);
 
+    // Advances the reactor unless paused; a paused sim only applies queued
+    // edits and any single steps requested from the playback window.
+    void stepSimulation(float dt);
+    void setPaused     (bool paused);
+    bool isPaused      () const { return paused_; }
+    void requestStep   ();
+    // Pauses and queues a restore of a recorded step; resuming continues
+    // from there.
+    bool scrubTo       (long long step);
+    // The step on screen, or the one a queued restore is going to.
+    long long getShownStep() const;
+
+    // Fast-forward steps the reactor with a fixed dt for as long as the
+    // frame budget allows, uncapped, and only presents every few frames.
+    void   setFastForward       (bool on);
+    bool   isFastForward        () const { return fast_forward_; }
+    // Sim seconds per wall second, over the last half second or so.
+    double getFastForwardRatio  () const { return fast_ratio_; }
+
+    // With present-on-change, a frame is only needed after the sim stepped,
+    // an input event arrived or a timer changed what a widget shows.
+    bool     needsRedraw  () const;
+    void     markPresented() { dirty_ = false; }
+    unsigned getFrameCap  () const { return fast_forward_ ? 0 : frame_cap_; }
+
 private:
     void createControlWindow();
     void createStatsWindow  ();
     void createReactorWindow();
+    void createPlaybackWindow();
     void createClockWidget();
+    void updateClockResolution();
+    void fastForward      ();
+    void resizeReactor    (int direction);
+    void openStatsArchive ();
+    bool handleCameraEvent(const sf::Event& event);
+    bool handleSelectionEvent(const sf::Event& event);
+    void drawSelection    (sf::RenderWindow& window);
 };
 
 #endif // REACTOR_UI_HPP
\ No newline at end of file
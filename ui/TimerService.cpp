@@ -0,0 +1,125 @@
+// TimerService.cpp
+#include "TimerService.hpp"
+#include "Events.hpp"
+#include "Widget.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+TimerService::TimerService(float tick) : tick_(std::max(tick, 1e-6f)) {}
+
+TimerService::TimerId TimerService::subscribe(float interval, Callback callback) {
+    unsigned index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<unsigned>(timers_.size());
+        timers_.emplace_back();
+    }
+
+    Timer& timer = timers_[index];
+    timer.callback = std::move(callback);
+    timer.interval = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::lround(interval / tick_)));
+    timer.expires  = now_ + timer.interval;
+    timer.active   = true;
+    active_count_++;
+
+    schedule(index);
+    return (static_cast<TimerId>(timer.generation) << 32) | index;
+}
+
+TimerService::TimerId TimerService::subscribe(Widget* widget, float interval) {
+    // The widget is held weakly: once it is destroyed, the next expiry
+    // drops the timer instead of calling into it.
+    std::weak_ptr<Widget*> handle = widget->getHandle();
+    auto id = std::make_shared<TimerId>(0);
+    *id = subscribe(interval, [this, handle, id]() {
+        if (std::shared_ptr<Widget*> alive = handle.lock()) {
+            IdleEvent event;
+            event.apply(*alive);
+        } else {
+            unsubscribe(*id);
+        }
+    });
+    return *id;
+}
+
+void TimerService::unsubscribe(TimerId id) {
+    unsigned index = static_cast<unsigned>(id & 0xffffffffu);
+    std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+    if (index >= timers_.size()) return;
+
+    Timer& timer = timers_[index];
+    if (!timer.active || timer.generation != generation) return;
+
+    // The wheel entry is dropped lazily when its bucket comes up; the slot
+    // is recycled only then, so a stale entry cannot fire a new timer.
+    timer.active = false;
+    timer.callback = nullptr;
+    active_count_--;
+}
+
+void TimerService::schedule(unsigned index) {
+    std::uint64_t expires = timers_[index].expires;
+    std::uint64_t delta   = expires - now_;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (std::uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    size_t slot = (expires >> (SLOT_BITS * level)) & (SLOTS - 1);
+    wheel_[level][slot].push_back(index);
+}
+
+size_t TimerService::step() {
+    now_++;
+    size_t fired = 0;
+
+    // Cascade coarser buckets that now fall within the finer wheels.
+    for (int level = 1; level < LEVELS; ++level) {
+        if ((now_ & ((std::uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+
+        size_t slot = (now_ >> (SLOT_BITS * level)) & (SLOTS - 1);
+        cascade_.clear();
+        cascade_.swap(wheel_[level][slot]);
+        for (unsigned index : cascade_) {
+            schedule(index);
+        }
+    }
+
+    due_.clear();
+    due_.swap(wheel_[0][now_ & (SLOTS - 1)]);
+
+    for (unsigned index : due_) {
+        Timer& timer = timers_[index];
+        if (!timer.active) {
+            timer.generation++;
+            free_.push_back(index);
+            continue;
+        }
+        if (timer.expires != now_) {
+            schedule(index);
+            continue;
+        }
+
+        timer.expires += timer.interval;
+        schedule(index);
+        // The callback may subscribe or unsubscribe; copy it in case
+        // timers_ reallocates underneath.
+        Callback callback = timer.callback;
+        callback();
+        fired++;
+    }
+    return fired;
+}
+
+size_t TimerService::advance(float dt) {
+    size_t fired = 0;
+    accumulator_ += dt;
+    while (accumulator_ >= tick_) {
+        accumulator_ -= tick_;
+        fired += step();
+    }
+    return fired;
+}
@@ -0,0 +1,64 @@
+// TimerService.hpp
+#ifndef TIMER_SERVICE_HPP
+#define TIMER_SERVICE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Widget;
+
+// Hierarchical timer wheel: LEVELS wheels of SLOTS buckets each, level L
+// covering SLOTS^(L+1) ticks. advance() only touches the bucket of the
+// current tick, cascading coarser buckets down as they come due, so the
+// cost follows the number of timers firing rather than the widget count.
+class TimerService {
+public:
+    using TimerId  = std::uint64_t;
+    using Callback = std::function<void()>;
+    // Never returned by subscribe(); unsubscribing it does nothing.
+    static const TimerId NO_TIMER = ~TimerId(0);
+
+private:
+    static const int LEVELS     = 4;
+    static const int SLOT_BITS  = 6;
+    static const int SLOTS      = 1 << SLOT_BITS;
+
+    struct Timer {
+        Callback      callback;
+        std::uint64_t interval   = 1;
+        std::uint64_t expires    = 0;
+        std::uint32_t generation = 0;
+        bool          active     = false;
+    };
+
+    float tick_;
+    float accumulator_ = 0;
+    std::uint64_t now_ = 0;
+    size_t active_count_ = 0;
+
+    std::vector<Timer>    timers_;
+    std::vector<unsigned> free_;
+    std::vector<unsigned> wheel_[LEVELS][SLOTS];
+    std::vector<unsigned> due_;
+    std::vector<unsigned> cascade_;
+
+    void schedule(unsigned index);
+    size_t step();
+
+public:
+    explicit TimerService(float tick = 0.001f);
+
+    // Fires `callback` every `interval` seconds (at least one tick).
+    TimerId subscribe(float interval, Callback callback);
+    // Sends an IdleEvent to `widget` every `interval` seconds, until the
+    // widget is destroyed or the timer unsubscribed.
+    TimerId subscribe(Widget* widget, float interval);
+    void    unsubscribe(TimerId id);
+
+    // Returns the number of callbacks fired.
+    size_t advance(float dt);
+    size_t getActiveCount() const { return active_count_; }
+};
+
+#endif // TIMER_SERVICE_HPP
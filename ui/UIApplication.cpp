@@ -67,20 +67,29 @@ void UIApplication::handleEvent(const sf::Event& sfml_event) {
             }
             break;
             
+        case sf::Event::MouseWheelScrolled:
+            if (sfml_event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+                sf::Vector2f position(static_cast<float>(sfml_event.mouseWheelScroll.x),
+                                      static_cast<float>(sfml_event.mouseWheelScroll.y));
+                
+                Widget* wheel_target = root_->getPointerTarget(position);
+                if (wheel_target) {
+                    MouseWheelEvent event(position, sfml_event.mouseWheelScroll.delta);
+                    event.apply(wheel_target);
+                }
+            }
+            break;
+            
         default:
             break;
     }
 }
 
-void UIApplication::update(float dt) {
-    if (!root_) return;
+bool UIApplication::update(float dt) {
+    if (!root_) return false;
     
-    idle_timer_ += dt;
-    if (idle_timer_ >= 1.0f) {
-        IdleEvent event;
-        event.apply(root_.get());
-        idle_timer_ = 0.f;
-    }
+    timers_.advance(dt);
+    return root_->takeInvalidated();
 }
 
 void UIApplication::render(sf::RenderWindow& window) {
@@ -6,6 +6,7 @@
 #include <vector>
 #include <SFML/Graphics.hpp>
 #include "Widget.hpp"
+#include "TimerService.hpp"
 
 class UIApplication {
 private:
@@ -14,7 +15,7 @@ private:
     Widget* hovered_widget_ = nullptr;  
     sf::Vector2f pointer_position_;
     bool pointer_pressed_ = false;
-    float idle_timer_ = 0.f; 
+    TimerService timers_;
 
 public:
      UIApplication();
@@ -33,8 +34,13 @@ public:
     bool         isPointerPressed  () const { return pointer_pressed_;  }
     void         setPointerPressed (bool pressed) { pointer_pressed_ = pressed; }
 
+    // Widgets that need periodic idle work subscribe here with their own
+    // interval instead of receiving a broadcast.
+    TimerService& getTimers() { return timers_; }
+
     void handleEvent(const sf::Event& sfml_event);
-    void update(float dt); 
+    // Runs due timers; true when one of them left a widget needing a redraw.
+    bool update(float dt);
     void render(sf::RenderWindow& window);
 };
 
@@ -3,53 +3,59 @@
 #include "Events.hpp"
 #include <algorithm>
 
+Widget::Widget() : handle_(std::make_shared<Widget*>(this)) {
+    flat_.push_back(this);
+    flat_pos_ = flat_.begin();
+}
+
+void Widget::invalidate() {
+    Widget* root = this;
+    while (root->parent_) root = root->parent_;
+    root->invalidated_ = true;
+}
+
+bool Widget::takeInvalidated() {
+    bool invalidated = invalidated_;
+    invalidated_ = false;
+    return invalidated;
+}
+
 bool Widget::contains(const sf::Vector2f& point) const {
     return rect_.contains(point);
 }
 
+// The last widget in pre-order whose whole ancestor chain contains the
+// point is the top-most, deepest hit. Subtrees that miss are skipped.
 Widget* Widget::getPointerTarget(const sf::Vector2f& point) {
     if (!contains(point) || !visible_) return nullptr;
     
-    for (auto it = children_.rbegin(); it != children_.rend(); ++it) {
-        auto& child = *it;
-        if (child->isVisible()) {
-            if (auto target = child->getPointerTarget(point)) {
-                return target;
-            }
+    Widget* target = this;
+    auto end = subtreeEnd();
+    for (auto it = std::next(flat_pos_); it != end; ) {
+        Widget* widget = *it;
+        if (widget->contains(point)) {
+            target = widget;
+            ++it;
+        } else {
+            it = widget->subtreeEnd();
         }
     }
     
-    return this;
+    return target;
 }
 
-void Widget::onMouseMove(MouseMoveEvent& event) {
-    for (auto it = children_.rbegin(); it != children_.rend(); ++it) {
-        auto& child = *it;
-        if (child->isVisible() && child->contains(event.getPosition())) {
-            child->onMouseMove(event);
-            if (!event.isBubbling()) return;
-        }
-    }
+// Pointer events go straight to the widget getPointerTarget() picks from
+// the flattened list; there is nothing left to hand down to children.
+void Widget::onMouseMove(MouseMoveEvent&) {
 }
 
-void Widget::onMouseDown(MouseButtonEvent& event) {
-    for (auto it = children_.rbegin(); it != children_.rend(); ++it) {
-        auto& child = *it;
-        if (child->isVisible() && child->contains(event.getPosition())) {
-            child->onMouseDown(event);
-            if (!event.isBubbling()) return;
-        }
-    }
+void Widget::onMouseDown(MouseButtonEvent&) {
 }
 
-void Widget::onMouseUp(MouseButtonEvent& event) {
-    for (auto it = children_.rbegin(); it != children_.rend(); ++it) {
-        auto& child = *it;
-        if (child->isVisible() && child->contains(event.getPosition())) {
-            child->onMouseUp(event);
-            if (!event.isBubbling()) return;
-        }
-    }
+void Widget::onMouseUp(MouseButtonEvent&) {
+}
+
+void Widget::onMouseWheel(MouseWheelEvent&) {
 }
 
 void Widget::onIdle() {
@@ -67,24 +73,126 @@ void Widget::onMouseLeave() {
 void Widget::render(sf::RenderWindow& window) {
     if (!visible_) return;
     
-    for (auto& child : children_) {
-        child->render(window);
+    auto end = subtreeEnd();
+    for (auto it = flat_pos_; it != end; ++it) {
+        (*it)->draw(window);
     }
 }
 
+void Widget::draw(sf::RenderWindow&) {
+}
+
 void Widget::addChild(std::unique_ptr<Widget> child) {
     child->parent_ = this;
-    children_.push_back(std::move(child));
     
-    std::sort(children_.begin(), children_.end(), 
-              [](const auto& a, const auto& b) { 
-                  return a->getZOrder() < b->getZOrder(); 
-              });
+    auto pos = std::upper_bound(children_.begin(), children_.end(), child->getZOrder(),
+                                [](int z, const auto& other) { return z < other->getZOrder(); });
+    size_t index = pos - children_.begin();
+    children_.insert(pos, std::move(child));
+    
+    if (children_[index]->visible_) {
+        linkChild(index);
+    }
 }
 
 void Widget::removeChild(Widget* child) {
-    children_.erase(std::remove_if(children_.begin(), children_.end(),
-        [child](const auto& ptr) { return ptr.get() == child; }), children_.end());
+    size_t index = childIndex(child);
+    if (index == children_.size()) return;
+    
+    if (child->visible_) {
+        unlinkChild(child);
+    }
+    children_.erase(children_.begin() + index);
+}
+
+void Widget::setZOrder(int order) {
+    if (!parent_) {
+        z_order_ = order;
+        return;
+    }
+    
+    Widget* parent = parent_;
+    size_t index = parent->childIndex(this);
+    if (visible_) {
+        parent->unlinkChild(this);
+    }
+    
+    std::unique_ptr<Widget> self = std::move(parent->children_[index]);
+    parent->children_.erase(parent->children_.begin() + index);
+    z_order_ = order;
+    
+    auto pos = std::upper_bound(parent->children_.begin(), parent->children_.end(), z_order_,
+                                [](int z, const auto& other) { return z < other->getZOrder(); });
+    index = pos - parent->children_.begin();
+    parent->children_.insert(pos, std::move(self));
+    
+    if (visible_) {
+        parent->linkChild(index);
+    }
+}
+
+void Widget::setVisible(bool visible) {
+    if (visible == visible_) return;
+    
+    if (!parent_) {
+        visible_ = visible;
+        return;
+    }
+    
+    if (!visible) {
+        parent_->unlinkChild(this);
+        visible_ = false;
+    } else {
+        visible_ = true;
+        parent_->linkChild(parent_->childIndex(this));
+    }
+}
+
+Widget* Widget::flatOwner() {
+    Widget* owner = this;
+    while (owner->parent_ && owner->visible_) {
+        owner = owner->parent_;
+    }
+    return owner;
+}
+
+std::list<Widget*>::iterator Widget::subtreeEnd() {
+    Widget* last = this;
+    for (;;) {
+        auto child = std::find_if(last->children_.rbegin(), last->children_.rend(),
+                                  [](const auto& c) { return c->visible_; });
+        if (child == last->children_.rend()) break;
+        last = child->get();
+    }
+    return std::next(last->flat_pos_);
+}
+
+// Moves the (visible) child's list into ours, right after the subtree of
+// the previous visible sibling.
+void Widget::linkChild(size_t index) {
+    Widget* child = children_[index].get();
+    
+    auto pos = std::next(flat_pos_);
+    for (size_t i = index; i-- > 0; ) {
+        if (children_[i]->visible_) {
+            pos = children_[i]->subtreeEnd();
+            break;
+        }
+    }
+    
+    flatOwner()->flat_.splice(pos, child->flat_);
+}
+
+// Moves the (visible) child's subtree out into its own list.
+void Widget::unlinkChild(Widget* child) {
+    child->flat_.splice(child->flat_.end(), flatOwner()->flat_, child->flat_pos_, child->subtreeEnd());
+}
+
+size_t Widget::childIndex(const Widget* child) const {
+    for (size_t i = 0; i < children_.size(); ++i) {
+        if (children_[i].get() == child) return i;
+    }
+    return children_.size();
 }
 
 void Widget::setPosition(float x, float y) {
@@ -2,12 +2,14 @@
 #ifndef WIDGET_HPP
 #define WIDGET_HPP
 
+#include <list>
 #include <memory>
 #include <vector>
 #include <SFML/Graphics.hpp>
 
 class MouseMoveEvent;
 class MouseButtonEvent;
+class MouseWheelEvent;
 
 class Widget {
 protected:
@@ -16,9 +18,19 @@ protected:
     Widget* parent_ = nullptr;
     int z_order_ = 0;
     bool visible_ = true;
+    bool invalidated_ = false;   // only used on the root
+
+    // Visible subtrees are kept flattened in pre-order (children by z-order)
+    // in the list of the nearest hidden or parentless ancestor-or-self, so
+    // rendering and hit testing walk a list instead of recursing. flat_ is
+    // that list when this widget heads one; flat_pos_ is this widget's entry.
+    std::list<Widget*> flat_;
+    std::list<Widget*>::iterator flat_pos_;
+
+    std::shared_ptr<Widget*> handle_;
 
 public:
-             Widget() = default;
+             Widget();
     virtual ~Widget() = default;
 
     virtual bool    contains        (const sf::Vector2f& point) const;
@@ -27,11 +39,15 @@ public:
     virtual void onMouseMove (MouseMoveEvent&   event);
     virtual void onMouseDown (MouseButtonEvent& event);
     virtual void onMouseUp   (MouseButtonEvent& event);
+    virtual void onMouseWheel(MouseWheelEvent&  event);
     virtual void onMouseEnter();
     virtual void onMouseLeave();
     virtual void onIdle      ();
     
-    virtual void render(sf::RenderWindow& window);
+    // Draws the whole visible subtree; subclasses override draw() for
+    // their own appearance only.
+    void render(sf::RenderWindow& window);
+    virtual void draw(sf::RenderWindow& window);
     
     void addChild(std::unique_ptr<Widget> child);
     void removeChild(Widget* child);
@@ -41,17 +57,33 @@ public:
     void setRect(const sf::FloatRect& rect);
     sf::FloatRect getRect() const { return rect_; }
     
-    void setZOrder(int order) { z_order_ = order; }
+    void setZOrder(int order);
     int getZOrder () const     {  return z_order_;}
     
-    void setVisible(bool visible)  { visible_ = visible; }
+    void setVisible(bool visible);
     bool isVisible () const        { return     visible_; }
     
     Widget*     getParent  () const { return parent_;   }
     const auto& getChildren() const { return children_; }
 
+    // Asks for a redraw. The flag is kept on the root of the tree, where
+    // takeInvalidated() collects it once per frame.
+    void invalidate();
+    bool takeInvalidated();
+
+    // Expires with the widget, so services that keep hold of it (timers)
+    // can tell it is gone without it having to unsubscribe.
+    std::weak_ptr<Widget*> getHandle() const { return handle_; }
+
 protected:
     virtual void updateLayout();
+
+private:
+    Widget* flatOwner();
+    std::list<Widget*>::iterator subtreeEnd();
+    void linkChild  (size_t index);
+    void unlinkChild(Widget* child);
+    size_t childIndex(const Widget* child) const;
 };
 
 #endif // WIDGET_HPP
\ No newline at end of file
@@ -36,9 +36,7 @@ void Window::onMouseUp(MouseButtonEvent& event) {
     Widget::onMouseUp(event);
 }
 
-void Window::render(sf::RenderWindow& window) {
-    if (!isVisible()) return;
-    
+void Window::draw(sf::RenderWindow& window) {
     sf::RectangleShape background(sf::Vector2f       (rect_.width, rect_.height));
                        background.setPosition        (rect_.left, rect_.top);
                        background.setFillColor       (sf::Color(40, 40, 50, 200));
@@ -50,8 +48,6 @@ void Window::render(sf::RenderWindow& window) {
     title_bar.setPosition(rect_.left, rect_.top);
     title_bar.setFillColor(sf::Color(60, 60, 80));
     window.draw(title_bar);
-    
-    Widget::render(window);
 }
 
 void Window::updateLayout() {
@@ -19,7 +19,7 @@
         void onMouseDown(MouseButtonEvent& event) override;
         void onMouseUp  (MouseButtonEvent& event) override;
         
-        void render    (sf::RenderWindow& window) override;
+        void draw      (sf::RenderWindow& window) override;
         
         void setTitle(const std::string& title) { title_ = title; }
         const std::string& getTitle() const     { return   title_;}